@@ -0,0 +1,50 @@
+#include "agregados.h"
+using namespace std;
+
+/*
+agregar :: Float -> Void
+Suma un valor al resumen.
+*/
+void Resumen::agregar(float valor) {
+    suma += valor;
+    cantidad++;
+    minimo = min(minimo, valor);
+    maximo = max(maximo, valor);
+}
+
+/*
+combinar :: Resumen -> Void
+Junta otro resumen con este.
+*/
+void Resumen::combinar(const Resumen &otro) {
+    suma += otro.suma;
+    cantidad += otro.cantidad;
+    minimo = min(minimo, otro.minimo);
+    maximo = max(maximo, otro.maximo);
+}
+
+/*
+de :: Int -> Resumen&
+Devuelve el resumen del nodo idx, agrandando el vector si el nodo es nuevo.
+*/
+Resumen &Agregados::de(int idx) {
+    if (idx >= (int)por_nodo.size()) por_nodo.resize(idx + 1);
+    return por_nodo[idx];
+}
+
+/*
+recalcular :: Int, Nodo -> Void
+Rehace el resumen del nodo idx a partir de su contenido: los pares de una hoja, o los resumenes de los hijos de un nodo interno.
+Se usa despues de cualquier cambio estructural (division, reparto, borrado), de abajo hacia arriba.
+*/
+void Agregados::recalcular(int idx, const Nodo &nodo) {
+    Resumen resumen;
+    if (!nodo.es_interno) {
+        for (int i = 0; i < nodo.k; ++i)
+            if (!es_lapida(nodo.pares[i])) resumen.agregar(nodo.pares[i].valor);
+    } else {
+        for (int i = 0; i <= nodo.k; ++i)
+            if (nodo.hijos[i] != -1) resumen.combinar(de(nodo.hijos[i]));
+    }
+    de(idx) = resumen;
+}
@@ -0,0 +1,43 @@
+#ifndef AGREGADOS_H
+#define AGREGADOS_H
+
+#include "nodo.h"
+
+/*
+Resumen :: struct
+Agregado de los valores de un subarbol (sin contar lapidas): cantidad, suma, minimo y maximo.
+*/
+struct Resumen {
+    double suma = 0.0;
+    uint32_t cantidad = 0;
+    float minimo = std::numeric_limits<float>::infinity();
+    float maximo = -std::numeric_limits<float>::infinity();
+
+    void agregar(float valor);
+    void combinar(const Resumen &otro);
+};
+
+/*
+BloqueResumen :: struct
+Resumenes de todos los hijos de un nodo interno, en el mismo orden que hijos[].
+Es lo que se guarda en el archivo lateral de agregados, un bloque por nodo interno.
+*/
+struct BloqueResumen {
+    Resumen hijos[B+1];
+};
+
+constexpr int Paginas_bloque_resumen = (sizeof(BloqueResumen) + Bytes_nodo - 1) / Bytes_nodo;
+
+/*
+Agregados :: struct
+Resumen del subarbol de cada nodo de un arbol B+, indexado igual que la ListaNodo.
+Se activa pasando un puntero en OpcionesArbol; la insercion, el borrado y la compactacion lo mantienen al dia.
+*/
+struct Agregados {
+    std::vector<Resumen> por_nodo;
+
+    Resumen &de(int idx);
+    void recalcular(int idx, const Nodo &nodo);
+};
+
+#endif
@@ -0,0 +1,230 @@
+#include "almacen.h"
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define ALMACEN_MMAP_POSIX 1
+#endif
+using namespace std;
+
+/*
+superbloque_de :: Almacen, Int, Bool -> Superbloque
+Arma el superbloque de un arbol guardado en el almacen. La altura se mide bajando por el hijo izquierdo
+desde la raiz; esas lecturas no se cuentan en los contadores del almacen.
+*/
+template <class Almacen>
+static Superbloque superbloque_de(Almacen &almacen, int raiz, bool es_Bplus) {
+    Superbloque sb{};
+    sb.raiz = raiz;
+    sb.es_Bplus = es_Bplus;
+    sb.cantidad_nodos = almacen.size();
+    uint64_t lecturas = almacen.reads;
+    int idx = raiz;
+    while (idx >= 0 && idx < almacen.size()) {
+        sb.altura++;
+        Nodo n = almacen.read(idx);
+        if (!n.es_interno) break;
+        idx = n.hijos[0];
+    }
+    almacen.reads = lecturas;
+    return sb;
+}
+
+AlmacenArchivo::AlmacenArchivo(const string &fname): filename(fname) {
+    archivo.open(filename, ios::binary | ios::in | ios::out | ios::trunc);
+    if (!archivo) throw runtime_error("No se pudo abrir archivo para escribir: " + filename);
+    Superbloque sb{};
+    archivo.write(reinterpret_cast<const char*>(&sb), sizeof(Superbloque));
+}
+
+/*
+read :: Int -> Nodo
+Lee la pagina idx + 1 del archivo.
+*/
+Nodo AlmacenArchivo::read(int idx) {
+    if (idx < 0 || idx >= cantidad) throw runtime_error("Índice inválido en AlmacenArchivo::read");
+    Nodo n;
+    archivo.seekg((std::streamoff)(idx + 1) * sizeof(Nodo), ios::beg);
+    archivo.read(reinterpret_cast<char*>(&n), sizeof(Nodo));
+    if (!archivo) throw runtime_error("Error al leer nodo del archivo " + filename);
+    reads++;
+    return n;
+}
+
+/*
+write :: Int, Nodo -> Void
+Escribe la pagina idx + 1 del archivo; escribir despues del final agranda el almacen.
+*/
+void AlmacenArchivo::write(int idx, const Nodo &n) {
+    archivo.seekp((std::streamoff)(idx + 1) * sizeof(Nodo), ios::beg);
+    archivo.write(reinterpret_cast<const char*>(&n), sizeof(Nodo));
+    if (!archivo) throw runtime_error("Error al escribir nodo en el archivo " + filename);
+    if (idx >= cantidad) cantidad = idx + 1;
+    writes++;
+}
+
+int AlmacenArchivo::append(const Nodo &n) {
+    write(cantidad, n);
+    return cantidad - 1;
+}
+
+/*
+fijar_raiz :: Int, Bool -> Void
+Escribe el superbloque con la raiz y el tipo de arbol, para que el archivo se pueda reabrir con DiskManager::open.
+*/
+void AlmacenArchivo::fijar_raiz(int raiz, bool es_Bplus) {
+    Superbloque sb = superbloque_de(*this, raiz, es_Bplus);
+    archivo.seekp(0, ios::beg);
+    archivo.write(reinterpret_cast<const char*>(&sb), sizeof(Superbloque));
+    archivo.flush();
+    writes++;
+}
+
+AlmacenCache::AlmacenCache(const string &fname, int capacidad): archivo(fname), capacidad(max(1, capacidad)) {}
+
+AlmacenCache::~AlmacenCache() {
+    try {
+        flush();
+    } catch (const runtime_error &) {
+    }
+}
+
+/*
+marco :: Int, Bool -> Marco&
+Devuelve el marco de la pagina idx y lo deja como el mas reciente. Si no esta, descarta el menos reciente
+(escribiendolo si esta sucio) y, si leer es verdadero, trae la pagina del archivo.
+*/
+AlmacenCache::Marco &AlmacenCache::marco(int idx, bool leer) {
+    auto it = ubicacion.find(idx);
+    if (it != ubicacion.end()) {
+        marcos.splice(marcos.begin(), marcos, it->second);
+        return marcos.front();
+    }
+    if ((int)marcos.size() >= capacidad) {
+        Marco &viejo = marcos.back();
+        if (viejo.sucio) {
+            archivo.write(viejo.idx, viejo.nodo);
+            writes++;
+        }
+        ubicacion.erase(viejo.idx);
+        marcos.pop_back();
+    }
+    marcos.push_front(Marco{idx, leer ? archivo.read(idx) : Nodo(), false});
+    if (leer) reads++;
+    ubicacion[idx] = marcos.begin();
+    return marcos.front();
+}
+
+/*
+read :: Int -> Nodo
+Lee la pagina idx desde la cache, trayendola del archivo si no esta.
+*/
+Nodo AlmacenCache::read(int idx) {
+    if (idx < 0 || idx >= size()) throw runtime_error("Índice inválido en AlmacenCache::read");
+    if (ubicacion.count(idx)) aciertos++;
+    return marco(idx, true).nodo;
+}
+
+/*
+write :: Int, Nodo -> Void
+Reemplaza la pagina idx en la cache y la marca sucia. No lee la pagina anterior, porque se reemplaza completa.
+*/
+void AlmacenCache::write(int idx, const Nodo &n) {
+    Marco &m = marco(idx, false);
+    m.nodo = n;
+    m.sucio = true;
+    if (idx >= archivo.cantidad) archivo.cantidad = idx + 1;
+}
+
+int AlmacenCache::append(const Nodo &n) {
+    int idx = size();
+    write(idx, n);
+    return idx;
+}
+
+/*
+flush :: -> Void
+Escribe al archivo todas las paginas sucias (quedan en la cache, ya limpias).
+*/
+void AlmacenCache::flush() {
+    for (Marco &m : marcos) {
+        if (!m.sucio) continue;
+        archivo.write(m.idx, m.nodo);
+        writes++;
+        m.sucio = false;
+    }
+    archivo.archivo.flush();
+}
+
+/*
+fijar_raiz :: Int, Bool -> Void
+Baja las paginas sucias al archivo y escribe el superbloque.
+*/
+void AlmacenCache::fijar_raiz(int raiz, bool es_Bplus) {
+    flush();
+    archivo.fijar_raiz(raiz, es_Bplus);
+}
+
+AlmacenMmap::AlmacenMmap(const string &fname): filename(fname) {
+#if ALMACEN_MMAP_POSIX
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw runtime_error("No se pudo abrir archivo para escribir: " + filename);
+#endif
+    crecer(1);
+    Superbloque sb{};
+    std::memcpy(base, static_cast<const void*>(&sb), sizeof(Superbloque));
+}
+
+/*
+~AlmacenMmap
+Deshace el mapeo y deja el archivo del largo justo (superbloque mas cantidad paginas).
+*/
+AlmacenMmap::~AlmacenMmap() {
+#if ALMACEN_MMAP_POSIX
+    if (base != nullptr) munmap(base, (size_t)(capacidad + 1) * sizeof(Nodo));
+    if (fd >= 0) {
+        int largo_ajustado = ftruncate(fd, (off_t)(cantidad + 1) * sizeof(Nodo));
+        (void)largo_ajustado;
+        ::close(fd);
+    }
+#else
+    ofstream ofs(filename, ios::binary | ios::out | ios::trunc);
+    ofs.write(reinterpret_cast<const char*>(respaldo.data()), (std::streamsize)(cantidad + 1) * sizeof(Nodo));
+#endif
+}
+
+/*
+crecer :: Int -> Void
+Agranda el almacen al doble (o mas, hasta que quepan minimo paginas). Con mmap se agranda el archivo y se vuelve a mapear.
+*/
+void AlmacenMmap::crecer(int minimo) {
+    int nueva = max(64, capacidad);
+    while (nueva < minimo) nueva *= 2;
+    if (nueva == capacidad) return;
+#if ALMACEN_MMAP_POSIX
+    if (base != nullptr) munmap(base, (size_t)(capacidad + 1) * sizeof(Nodo));
+    size_t largo = (size_t)(nueva + 1) * sizeof(Nodo);
+    if (ftruncate(fd, (off_t)largo) != 0) throw runtime_error("No se pudo agrandar el archivo " + filename);
+    void *p = mmap(nullptr, largo, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        base = nullptr;
+        throw runtime_error("No se pudo mapear el archivo " + filename);
+    }
+    base = static_cast<char*>(p);
+#else
+    respaldo.resize(nueva + 1);
+    base = reinterpret_cast<char*>(respaldo.data());
+#endif
+    capacidad = nueva;
+}
+
+/*
+fijar_raiz :: Int, Bool -> Void
+Escribe el superbloque en la pagina 0 del mapeo.
+*/
+void AlmacenMmap::fijar_raiz(int raiz, bool es_Bplus) {
+    Superbloque sb = superbloque_de(*this, raiz, es_Bplus);
+    std::memcpy(base, static_cast<const void*>(&sb), sizeof(Superbloque));
+    writes++;
+}
@@ -0,0 +1,135 @@
+#ifndef ALMACEN_H
+#define ALMACEN_H
+
+#include "manejodisco.h"
+
+/*
+Almacenes de nodos.
+La insercion (insert, split_with_sibling) y la busqueda (range_search_B, range_search_Bplus) son plantillas sobre
+el almacen donde viven las paginas del arbol. Un almacen es cualquier tipo con:
+    Nodo read(int idx)                     lee la pagina idx
+    void write(int idx, const Nodo &n)     escribe la pagina idx (puede ser una pagina nueva al final)
+    int append(const Nodo &n)              agrega una pagina y devuelve su posicion
+    int size() const                       cantidad de paginas
+    uint64_t reads, writes                 contadores de lecturas y escrituras
+ListaNodo es el almacen en memoria. Los de este archivo guardan las paginas en un archivo con el mismo formato que
+DiskManager (superbloque en la pagina 0, el nodo idx en la pagina idx + 1), asi que lo que construyen se puede
+reabrir con DiskManager::open y consultar con las funciones _disk.
+Las plantillas se instancian en btree.cpp, busqueda.cpp y driver.cpp para cada almacen de este archivo.
+*/
+
+/*
+AlmacenArchivo :: struct
+Cada lectura y escritura es una transferencia de una pagina con el archivo (pasando por el cache del sistema operativo).
+Los contadores cuentan esas transferencias.
+*/
+struct AlmacenArchivo {
+    std::string filename;
+    std::fstream archivo;
+    int cantidad = 0;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+
+    explicit AlmacenArchivo(const std::string &fname);
+    AlmacenArchivo(const AlmacenArchivo &) = delete;
+    AlmacenArchivo &operator=(const AlmacenArchivo &) = delete;
+
+    int size() const { return cantidad; }
+    Nodo read(int idx);
+    void write(int idx, const Nodo &n);
+    int append(const Nodo &n);
+    void fijar_raiz(int raiz, bool es_Bplus);
+};
+
+/*
+Paginas que guarda AlmacenCache por defecto (4 MB).
+*/
+constexpr int Capacidad_cache_paginas = 1024;
+
+/*
+AlmacenCache :: struct
+Cache de paginas LRU de capacidad paginas sobre un AlmacenArchivo, con escritura diferida: una escritura solo marca
+la pagina como sucia y se escribe al archivo cuando se descarta o en flush.
+Los contadores cuentan solo lo que llega al archivo (fallos de lectura y paginas sucias escritas); aciertos cuenta
+las lecturas que se respondieron desde la cache.
+*/
+struct AlmacenCache {
+    struct Marco {
+        int idx;
+        Nodo nodo;
+        bool sucio;
+    };
+
+    AlmacenArchivo archivo;
+    int capacidad;
+    std::list<Marco> marcos;   // del mas reciente al menos reciente
+    std::unordered_map<int, std::list<Marco>::iterator> ubicacion;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t aciertos = 0;
+
+    explicit AlmacenCache(const std::string &fname, int capacidad = Capacidad_cache_paginas);
+    ~AlmacenCache();
+
+    int size() const { return archivo.size(); }
+    Nodo read(int idx);
+    void write(int idx, const Nodo &n);
+    int append(const Nodo &n);
+    void flush();
+    void fijar_raiz(int raiz, bool es_Bplus);
+
+private:
+    Marco &marco(int idx, bool leer);
+};
+
+/*
+AlmacenMmap :: struct
+Paginas mapeadas en memoria: leer y escribir son copias dentro del mapeo y el sistema operativo se encarga de llevar
+las paginas al archivo. Al llenarse, el archivo y el mapeo crecen al doble. Los contadores cuentan accesos a paginas.
+read y write se definen aqui para que las plantillas de insercion y busqueda las puedan expandir en linea.
+En sistemas sin mmap las paginas se guardan en memoria y el archivo se escribe completo al destruir el almacen.
+*/
+struct AlmacenMmap {
+    std::string filename;
+    char *base = nullptr;
+    int capacidad = 0;
+    int cantidad = 0;
+    int fd = -1;
+    std::vector<Nodo> respaldo;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+
+    explicit AlmacenMmap(const std::string &fname);
+    AlmacenMmap(const AlmacenMmap &) = delete;
+    AlmacenMmap &operator=(const AlmacenMmap &) = delete;
+    ~AlmacenMmap();
+
+    int size() const { return cantidad; }
+
+    Nodo read(int idx) {
+        if (idx < 0 || idx >= cantidad) throw std::runtime_error("Índice inválido en AlmacenMmap::read");
+        reads++;
+        Nodo n;
+        std::memcpy(static_cast<void*>(&n), base + (size_t)(idx + 1) * sizeof(Nodo), sizeof(Nodo));
+        return n;
+    }
+
+    void write(int idx, const Nodo &n) {
+        if (idx >= capacidad) crecer(idx + 1);
+        if (idx >= cantidad) cantidad = idx + 1;
+        std::memcpy(base + (size_t)(idx + 1) * sizeof(Nodo), static_cast<const void*>(&n), sizeof(Nodo));
+        writes++;
+    }
+
+    int append(const Nodo &n) {
+        write(cantidad, n);
+        return cantidad - 1;
+    }
+
+    void fijar_raiz(int raiz, bool es_Bplus);
+
+private:
+    void crecer(int minimo);
+};
+
+#endif
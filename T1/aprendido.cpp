@@ -0,0 +1,103 @@
+#include "aprendido.h"
+#include <algorithm>
+using namespace std;
+
+/*
+tam_modelo_bytes :: -> Size
+Bytes que ocupa el modelo en memoria (lo que reemplaza a los nodos internos de un B+).
+*/
+size_t IndiceAprendido::tam_modelo_bytes() const {
+    return segmentos.size() * sizeof(Segmento);
+}
+
+/*
+predecir :: Int -> Int
+Busca el segmento de la llave y devuelve la posicion estimada donde empiezan las llaves >= llave.
+La prediccion se acota por el inicio del segmento siguiente, para que una llave que cae entre dos segmentos no se extrapole de mas.
+*/
+int IndiceAprendido::predecir(int llave) const {
+    if (segmentos.empty()) return 0;
+    auto it = upper_bound(segmentos.begin(), segmentos.end(), llave,
+                          [](int x, const Segmento &s) { return x < s.llave_inicio; });
+    if (it == segmentos.begin()) return 0;
+    const Segmento &seg = *(it - 1);
+    double pos = seg.posicion_inicio + seg.pendiente * ((double)llave - seg.llave_inicio);
+    int limite = (it == segmentos.end()) ? n : it->posicion_inicio;
+    return (int)max(0.0, min(pos, (double)limite));
+}
+
+/*
+construir_aprendido :: vector<pair<Int,Float>>, DiskManager, Int -> IndiceAprendido
+Ordena los pares por llave, los escribe en paginas hoja consecutivas y ajusta el modelo lineal por partes.
+Cada segmento se ajusta con un cono que se va angostando: parte en la primera llave distinta del tramo y se extiende
+mientras exista una pendiente que deje todas las llaves del tramo a distancia epsilon de su posicion real.
+Con llaves repetidas se modela la primera posicion de cada llave.
+*/
+IndiceAprendido construir_aprendido(vector<pair<int,float>> datos, DiskManager &dm, int epsilon) {
+    stable_sort(datos.begin(), datos.end(),
+                [](const pair<int,float> &a, const pair<int,float> &b) { return a.first < b.first; });
+
+    IndiceAprendido indice;
+    indice.epsilon = epsilon;
+    indice.n = (int)datos.size();
+
+    ListaNodo paginas;
+    for (size_t i = 0; i < datos.size(); i += B) {
+        Nodo hoja;
+        for (size_t j = i; j < datos.size() && j < i + B; ++j) {
+            hoja.pares[hoja.k].llave = datos[j].first;
+            hoja.pares[hoja.k].valor = datos[j].second;
+            hoja.k++;
+        }
+        hoja.siguiente = (i + B < datos.size()) ? paginas.size() + 1 : -1;
+        paginas.append(hoja);
+    }
+    dm.write_all(paginas);
+    indice.paginas = paginas.size();
+
+    size_t i = 0;
+    while (i < datos.size()) {
+        Segmento seg{datos[i].first, (int)i, 0.0};
+        double pendiente_min = 0.0, pendiente_max = numeric_limits<double>::infinity();
+        size_t j = i;
+        while (j < datos.size() && datos[j].first == seg.llave_inicio) ++j;
+        while (j < datos.size()) {
+            double dx = (double)datos[j].first - seg.llave_inicio;
+            double dy = (double)j - seg.posicion_inicio;
+            double lo = max(pendiente_min, (dy - epsilon) / dx);
+            double hi = min(pendiente_max, (dy + epsilon) / dx);
+            if (lo > hi) break;
+            pendiente_min = lo;
+            pendiente_max = hi;
+            int llave = datos[j].first;
+            while (j < datos.size() && datos[j].first == llave) ++j;
+        }
+        seg.pendiente = isinf(pendiente_max) ? pendiente_min : (pendiente_min + pendiente_max) / 2;
+        indice.segmentos.push_back(seg);
+        i = j;
+    }
+    return indice;
+}
+
+/*
+range_search_aprendido_disk :: DiskManager, IndiceAprendido, Int, Int, Int& -> vector<pair<Int,Float>>
+Busqueda de rango con el mismo contrato que range_search_Bplus_disk.
+El modelo da la posicion estimada de la primera llave >= l; la busqueda de la ultima milla parte epsilon posiciones
+antes (la posicion real nunca esta antes de eso) y desde ahi recorre las paginas hacia adelante hasta pasar u.
+*/
+vector<pair<int,float>> range_search_aprendido_disk(DiskManager &dm, const IndiceAprendido &indice, int l, int u, int &io_busquedas) {
+    vector<pair<int,float>> out;
+    if (indice.n == 0 || l > u) return out;
+    int desde = max(0, indice.predecir(l) - indice.epsilon);
+    int pagina = desde / B;
+    while (pagina != -1 && pagina < indice.paginas) {
+        io_busquedas++;
+        Nodo hoja = dm.read_node_at(pagina);
+        for (int i = 0; i < hoja.k; ++i) {
+            if (hoja.pares[i].llave > u) return out;
+            if (hoja.pares[i].llave >= l) out.emplace_back(hoja.pares[i].llave, hoja.pares[i].valor);
+        }
+        pagina = hoja.siguiente;
+    }
+    return out;
+}
@@ -0,0 +1,41 @@
+#ifndef APRENDIDO_H
+#define APRENDIDO_H
+
+#include "manejodisco.h"
+
+/*
+Error maximo (en posiciones) de la prediccion del modelo. Con EPSILON_APRENDIDO < B la busqueda de la ultima milla
+cae en a lo mas dos paginas.
+*/
+constexpr int EPSILON_APRENDIDO = 64;
+
+/*
+Segmento :: struct
+Tramo del modelo lineal por partes: para llaves desde llave_inicio predice la posicion
+posicion_inicio + pendiente * (llave - llave_inicio) con error a lo mas epsilon.
+*/
+struct Segmento {
+    int llave_inicio;
+    int posicion_inicio;
+    double pendiente;
+};
+
+/*
+IndiceAprendido :: struct
+Indice aprendido al estilo PGM sobre los pares ordenados por llave y guardados en paginas hoja (Nodo con B pares,
+enlazadas por siguiente). El modelo vive en memoria y predice en que posicion del arreglo ordenado empieza un rango.
+*/
+struct IndiceAprendido {
+    int epsilon = EPSILON_APRENDIDO;
+    int n = 0;
+    int paginas = 0;
+    std::vector<Segmento> segmentos;
+
+    size_t tam_modelo_bytes() const;
+    int predecir(int llave) const;
+};
+
+IndiceAprendido construir_aprendido(std::vector<std::pair<int,float>> datos, DiskManager &dm, int epsilon = EPSILON_APRENDIDO);
+std::vector<std::pair<int,float>> range_search_aprendido_disk(DiskManager &dm, const IndiceAprendido &indice, int l, int u, int &io_busquedas);
+
+#endif
@@ -0,0 +1,133 @@
+#include "arena.h"
+#include <new>
+#include <fstream>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+/*
+pedir_bloque :: Bool -> Nodo*
+Reserva un bloque de Bytes_bloque_arena bytes alineado a 2 MB.
+*/
+static Nodo *pedir_bloque(bool prefault) {
+    void *p = nullptr;
+#if defined(__linux__)
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_HUGETLB)
+    p = mmap(nullptr, Bytes_bloque_arena, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | (prefault ? MAP_POPULATE : 0), -1, 0);
+    if (p == MAP_FAILED) p = nullptr;
+#endif
+    if (p == nullptr) {
+        // Sin paginas enormes explicitas: se pide el doble y se recorta para quedar alineado a 2 MB
+        char *crudo = (char *)mmap(nullptr, 2 * Bytes_bloque_arena, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (crudo == MAP_FAILED) throw bad_alloc();
+        uintptr_t inicio = ((uintptr_t)crudo + Bytes_bloque_arena - 1) & ~(uintptr_t)(Bytes_bloque_arena - 1);
+        char *alineado = (char *)inicio;
+        if (alineado > crudo) munmap(crudo, alineado - crudo);
+        char *fin = crudo + 2 * Bytes_bloque_arena;
+        if (fin > alineado + Bytes_bloque_arena) munmap(alineado + Bytes_bloque_arena, fin - (alineado + Bytes_bloque_arena));
+        p = alineado;
+#if defined(MADV_HUGEPAGE)
+        madvise(p, Bytes_bloque_arena, MADV_HUGEPAGE);
+#endif
+        if (prefault) {
+            long pagina = sysconf(_SC_PAGESIZE);
+            for (size_t off = 0; off < Bytes_bloque_arena; off += pagina) ((volatile char *)p)[off] = 0;
+        }
+    }
+#else
+    p = ::operator new(Bytes_bloque_arena, align_val_t(Bytes_bloque_arena));
+    (void)prefault;
+#endif
+    return static_cast<Nodo *>(p);
+}
+
+/*
+soltar_bloque :: Nodo* -> Void
+Devuelve un bloque al sistema operativo.
+*/
+static void soltar_bloque(Nodo *bloque) {
+#if defined(__linux__)
+    munmap(bloque, Bytes_bloque_arena);
+#else
+    ::operator delete(bloque, align_val_t(Bytes_bloque_arena));
+#endif
+}
+
+ArenaNodos::ArenaNodos(ArenaNodos &&otro) noexcept
+    : bloques(std::move(otro.bloques)), n(otro.n), prefault(otro.prefault) {
+    otro.bloques.clear();
+    otro.n = 0;
+}
+
+ArenaNodos &ArenaNodos::operator=(ArenaNodos &&otro) noexcept {
+    if (this != &otro) {
+        for (Nodo *bloque : bloques) soltar_bloque(bloque);
+        bloques = std::move(otro.bloques);
+        n = otro.n;
+        prefault = otro.prefault;
+        otro.bloques.clear();
+        otro.n = 0;
+    }
+    return *this;
+}
+
+ArenaNodos::~ArenaNodos() {
+    for (Nodo *bloque : bloques) soltar_bloque(bloque);
+}
+
+/*
+push_back :: Nodo -> Void
+Agrega un nodo al final; si el ultimo bloque esta lleno pide uno nuevo. Los nodos existentes no se mueven.
+*/
+void ArenaNodos::push_back(const Nodo &nodo) {
+    if (n == bloques.size() * Nodos_por_bloque) bloques.push_back(pedir_bloque(prefault));
+    new (&(*this)[n]) Nodo(nodo);
+    n++;
+}
+
+/*
+resize :: Size -> Void
+Agranda el arena hasta nuevo_n nodos, inicializando los nuevos con Nodo(). No achica.
+*/
+void ArenaNodos::resize(size_t nuevo_n) {
+    while (n < nuevo_n) push_back(Nodo());
+}
+
+/*
+bytes_reservados :: -> Size
+Memoria pedida al sistema por el arena.
+*/
+size_t ArenaNodos::bytes_reservados() const {
+    return bloques.size() * Bytes_bloque_arena;
+}
+
+/*
+rss_actual_bytes :: -> Size
+Memoria residente del proceso (Linux: /proc/self/statm). Devuelve 0 si no se puede medir.
+*/
+size_t rss_actual_bytes() {
+#if defined(__linux__)
+    ifstream ifs("/proc/self/statm");
+    size_t total = 0, residente = 0;
+    if (ifs >> total >> residente) return residente * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+}
+
+/*
+rss_pico_bytes :: -> Size
+Maximo de memoria residente del proceso (Linux: VmHWM de /proc/self/status). Devuelve 0 si no se puede medir.
+*/
+size_t rss_pico_bytes() {
+#if defined(__linux__)
+    ifstream ifs("/proc/self/status");
+    string linea;
+    while (getline(ifs, linea)) {
+        if (linea.rfind("VmHWM:", 0) == 0) return stoull(linea.substr(6)) * 1024;
+    }
+#endif
+    return 0;
+}
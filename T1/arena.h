@@ -0,0 +1,43 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "nodo.h"
+
+/*
+Cada bloque del arena ocupa una pagina enorme de 2 MB (512 nodos de 4 KB).
+*/
+constexpr size_t Bytes_bloque_arena = 2u << 20;
+constexpr size_t Nodos_por_bloque = Bytes_bloque_arena / sizeof(Nodo);
+
+/*
+ArenaNodos :: struct
+Almacen de nodos en bloques de 2 MB que nunca se mueven: agregar un nodo es O(1) y no copia los anteriores
+(a diferencia de vector<Nodo>, que al crecer copia el arbol completo), y la direccion de un nodo es estable.
+En Linux cada bloque se pide con mmap, primero como pagina enorme explicita (MAP_HUGETLB) y si no hay,
+como memoria normal alineada a 2 MB con madvise(MADV_HUGEPAGE). Con prefault los bloques se tocan al pedirlos.
+En otros sistemas se usa new alineado.
+*/
+struct ArenaNodos {
+    std::vector<Nodo*> bloques;
+    size_t n = 0;
+    bool prefault = false;
+
+    ArenaNodos() = default;
+    ArenaNodos(const ArenaNodos &) = delete;
+    ArenaNodos &operator=(const ArenaNodos &) = delete;
+    ArenaNodos(ArenaNodos &&otro) noexcept;
+    ArenaNodos &operator=(ArenaNodos &&otro) noexcept;
+    ~ArenaNodos();
+
+    size_t size() const { return n; }
+    Nodo &operator[](size_t idx) { return bloques[idx / Nodos_por_bloque][idx % Nodos_por_bloque]; }
+    const Nodo &operator[](size_t idx) const { return bloques[idx / Nodos_por_bloque][idx % Nodos_por_bloque]; }
+    void push_back(const Nodo &nodo);
+    void resize(size_t nuevo_n);
+    size_t bytes_reservados() const;
+};
+
+size_t rss_actual_bytes();
+size_t rss_pico_bytes();
+
+#endif
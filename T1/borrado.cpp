@@ -0,0 +1,274 @@
+#include "borrado.h"
+#include <stdexcept>
+using namespace std;
+
+/*
+erase_range :: ListaNodo, Int, Int, Int, Bool, OpcionesArbol -> Int
+Marca como lapida todos los pares con llave en [l, u] y devuelve cuantos marco.
+Solo se visitan los nodos cuyo rango se solapa con [l, u], y solo se escriben los que cambiaron.
+En un arbol B los pares de los nodos internos tambien son datos, asi que se marcan igual que en las hojas;
+en un B+ los pares internos son solo separadores y no se tocan.
+La estructura del arbol no cambia: juntar nodos que quedaron con poca ocupacion es trabajo de compact_range.
+Con agregados, los resumenes de los nodos tocados se rehacen al volver de la recursion.
+Con cache de rangos, [l, u] se saca de los tramos guardados en cuanto se marca alguna lapida.
+*/
+int erase_range(ListaNodo &lista_nodos, int indice_nodo, int l, int u, bool es_Bplus, const OpcionesArbol &opciones) {
+    if (indice_nodo == -1 || l > u) return 0;
+    Nodo nodo = lista_nodos.read(indice_nodo);
+    int marcados = 0;
+    if (!nodo.es_interno || !es_Bplus) {
+        for (int i = 0; i < nodo.k; ++i) {
+            if (nodo.pares[i].llave >= l && nodo.pares[i].llave <= u && !es_lapida(nodo.pares[i])) {
+                marcar_lapida(nodo.pares[i]);
+                marcados++;
+            }
+        }
+        if (marcados > 0) {
+            lista_nodos.write(indice_nodo, nodo);
+            if (opciones.cache != nullptr) opciones.cache->invalidar(l, u);
+        }
+    }
+    if (nodo.es_interno) {
+        for (int i = 0; i <= nodo.k; ++i)
+            if (hijo_solapa(nodo, i, l, u))
+                marcados += erase_range(lista_nodos, nodo.hijos[i], l, u, es_Bplus, opciones);
+    }
+    if (marcados > 0) refresh_summary(opciones, es_Bplus, indice_nodo, nodo);
+    return marcados;
+}
+
+/*
+erase :: ListaNodo, Int, Int, Bool, OpcionesArbol -> Int
+Marca como lapida los pares con la llave dada (puede haber mas de uno si la llave se repite).
+*/
+int erase(ListaNodo &lista_nodos, int indice_raiz, int llave, bool es_Bplus, const OpcionesArbol &opciones) {
+    return erase_range(lista_nodos, indice_raiz, llave, llave, es_Bplus, opciones);
+}
+
+/*
+rebalance_child :: ListaNodo, Nodo, Int, Nodo, Bool, OpcionesArbol -> Int
+Junta el hijo i del padre con un hermano adyacente si el contenido de ambos cabe en un nodo,
+y si no cabe lo reparte de forma pareja entre los dos. Prefiere al hermano derecho.
+Actualiza el padre en memoria (el llamador lo escribe) y devuelve la cantidad de pares con que quedo el hijo i.
+*/
+static int rebalance_child(ListaNodo &lista_nodos, Nodo &padre, int i, const Nodo &hijo, bool es_Bplus,
+                           const OpcionesArbol &opciones) {
+    int izq = (i < padre.k) ? i : i - 1;
+    Nodo nodo_izq = (izq == i) ? hijo : lista_nodos.read(padre.hijos[izq]);
+    Nodo nodo_der = (izq == i) ? lista_nodos.read(padre.hijos[izq + 1]) : hijo;
+    int indice_izq = padre.hijos[izq];
+    int indice_der = padre.hijos[izq + 1];
+    int siguiente_der = nodo_der.siguiente;
+    int anterior_izq = anterior(nodo_izq);
+
+    purge_tombstones(nodo_izq);
+    purge_tombstones(nodo_der);
+    bool hoja_Bplus = es_Bplus && !nodo_izq.es_interno;
+    int total = nodo_izq.k + nodo_der.k + (hoja_Bplus ? 0 : 1);
+    int partes = (total <= B) ? 1 : 2;
+
+    Reparto reparto = redistribute({nodo_izq, nodo_der}, {padre.pares[izq]}, partes, es_Bplus);
+    if (partes == 1) {
+        if (!nodo_izq.es_interno) {
+            reparto.nodos[0].siguiente = siguiente_der;
+            if (es_Bplus) anterior(reparto.nodos[0]) = anterior_izq;
+            link_back(lista_nodos, opciones, es_Bplus, siguiente_der, indice_izq);
+        }
+        lista_nodos.write(indice_izq, reparto.nodos[0]);
+        refresh_summary(opciones, es_Bplus, indice_izq, reparto.nodos[0]);
+        index_leaf(opciones, es_Bplus, indice_izq, reparto.nodos[0]);
+        lista_nodos.liberar(indice_der);
+        replace_children(padre, izq, 2, {indice_izq}, {});
+        return reparto.nodos[0].k;
+    }
+    if (!nodo_izq.es_interno) {
+        reparto.nodos[0].siguiente = indice_der;
+        reparto.nodos[1].siguiente = siguiente_der;
+        if (es_Bplus) {
+            anterior(reparto.nodos[0]) = anterior_izq;
+            anterior(reparto.nodos[1]) = indice_izq;
+        }
+    }
+    lista_nodos.write(indice_izq, reparto.nodos[0]);
+    lista_nodos.write(indice_der, reparto.nodos[1]);
+    refresh_summary(opciones, es_Bplus, indice_izq, reparto.nodos[0]);
+    refresh_summary(opciones, es_Bplus, indice_der, reparto.nodos[1]);
+    index_leaf(opciones, es_Bplus, indice_izq, reparto.nodos[0]);
+    index_leaf(opciones, es_Bplus, indice_der, reparto.nodos[1]);
+    replace_children(padre, izq, 2, {indice_izq, indice_der}, reparto.separadores);
+    return reparto.nodos[i - izq].k;
+}
+
+/*
+take_extreme :: ListaNodo, Int, Bool, LlaveValor& -> Bool
+Saca el ultimo par (o el primero si ultimo es false) de la hoja mas a la derecha (o a la izquierda) del subarbol.
+En un arbol B ese par es el mayor (o menor) del subarbol. Devuelve false si la hoja esta vacia o el par es lapida.
+*/
+static bool take_extreme(ListaNodo &lista_nodos, int indice_nodo, bool ultimo, LlaveValor &par) {
+    if (indice_nodo == -1) return false;
+    Nodo nodo = lista_nodos.read(indice_nodo);
+    if (nodo.es_interno) return take_extreme(lista_nodos, nodo.hijos[ultimo ? nodo.k : 0], ultimo, par);
+    if (nodo.k == 0) return false;
+    par = nodo.pares[ultimo ? nodo.k - 1 : 0];
+    if (es_lapida(par)) return false;
+    if (!ultimo) for (int i = 1; i < nodo.k; ++i) nodo.pares[i - 1] = nodo.pares[i];
+    nodo.k--;
+    lista_nodos.write(indice_nodo, nodo);
+    return true;
+}
+
+/*
+purge_internal_tombstones :: ListaNodo, Nodo, Int, Int -> Bool
+En un arbol B los pares de los nodos internos son datos y a la vez separan hijos, asi que una lapida no se puede
+sacar sin mas. Cada lapida del nodo con llave en [l, u] se reemplaza por su predecesor, que se saca de la hoja mas a
+la derecha del hijo izquierdo, o si esa hoja esta vacia por su sucesor, de la hoja mas a la izquierda del hijo derecho.
+El par que sube sigue separando a los dos hijos. Si los dos lados estan vacios la lapida queda como separador.
+Devuelve true si el nodo cambio (el llamador lo escribe).
+*/
+static bool purge_internal_tombstones(ListaNodo &lista_nodos, Nodo &nodo, int l, int u) {
+    bool cambio = false;
+    for (int i = 0; i < nodo.k; ++i) {
+        if (!es_lapida(nodo.pares[i]) || nodo.pares[i].llave < l || nodo.pares[i].llave > u) continue;
+        LlaveValor par;
+        if (take_extreme(lista_nodos, nodo.hijos[i], true, par) || take_extreme(lista_nodos, nodo.hijos[i + 1], false, par)) {
+            nodo.pares[i] = par;
+            cambio = true;
+        }
+    }
+    return cambio;
+}
+
+/*
+compact_node :: ListaNodo, Int, Int, Int, Bool, OpcionesArbol -> Int
+Compacta recursivamente el subarbol del nodo dado, limitado a la parte que se solapa con [l, u].
+Las hojas pierden sus lapidas; en los nodos internos de un arbol B las lapidas se reemplazan por un par vecino
+(ver purge_internal_tombstones), y cada hijo que quedo bajo MIN_OCUPACION se junta o redistribuye con un hermano.
+Devuelve la cantidad de pares con que quedo el nodo.
+*/
+static int compact_node(ListaNodo &lista_nodos, int indice_nodo, int l, int u, bool es_Bplus, const OpcionesArbol &opciones) {
+    Nodo nodo = lista_nodos.read(indice_nodo);
+    if (!nodo.es_interno) {
+        if (purge_tombstones(nodo) > 0) lista_nodos.write(indice_nodo, nodo);
+        return nodo.k;
+    }
+
+    // Primero se compactan los hijos del rango, guardando con cuantos pares quedo cada uno
+    vector<int> ocupacion(nodo.k + 1, -1);
+    for (int i = 0; i <= nodo.k; ++i)
+        if (hijo_solapa(nodo, i, l, u))
+            ocupacion[i] = compact_node(lista_nodos, nodo.hijos[i], l, u, es_Bplus, opciones);
+
+    // Las lapidas del nodo se reemplazan antes de repartir, para que no bajen como separador a un hijo
+    bool cambio = !es_Bplus && purge_internal_tombstones(lista_nodos, nodo, l, u);
+
+    // Luego se arreglan en un solo lote los hijos que quedaron con poca ocupacion
+    int i = 0;
+    while (i <= nodo.k && nodo.k > 0) {
+        if (ocupacion[i] == -1 || ocupacion[i] >= MIN_OCUPACION) { i++; continue; }
+        Nodo hijo = lista_nodos.read(nodo.hijos[i]);
+        int hijos_antes = nodo.k + 1;
+        int k_hijo = rebalance_child(lista_nodos, nodo, i, hijo, es_Bplus, opciones);
+        cambio = true;
+        if (nodo.k + 1 < hijos_antes) {
+            // Se juntaron dos hijos en uno: el resultado queda en la posicion del izquierdo
+            int izq = (i < hijos_antes - 1) ? i : i - 1;
+            ocupacion.erase(ocupacion.begin() + izq + 1);
+            ocupacion[izq] = k_hijo;
+            i = izq;
+            if (k_hijo >= MIN_OCUPACION) i++;
+        } else {
+            ocupacion[i] = k_hijo;
+            i++;
+        }
+    }
+    if (cambio) lista_nodos.write(indice_nodo, nodo);
+    return nodo.k;
+}
+
+/*
+compact_range :: ListaNodo, Int&, Int, Int, Bool, OpcionesArbol -> Void
+Pasada de compactacion en lote para la zona [l, u] (pensada para correr despues de erase_range).
+Su costo es proporcional a las paginas de esa zona y no al tamaño del arbol.
+Es sincronica: no hay un hilo que compacte en segundo plano, el llamador decide cuando correrla.
+Si la raiz interna queda sin llaves, su unico hijo pasa a ser la nueva raiz.
+*/
+void compact_range(ListaNodo &lista_nodos, int &indice_raiz, int l, int u, bool es_Bplus, const OpcionesArbol &opciones) {
+    if (indice_raiz == -1 || l > u) return;
+    compact_node(lista_nodos, indice_raiz, l, u, es_Bplus, opciones);
+    Nodo raiz = lista_nodos.read(indice_raiz);
+    while (raiz.es_interno && raiz.k == 0) {
+        int nueva_raiz = raiz.hijos[0];
+        lista_nodos.liberar(indice_raiz);
+        indice_raiz = nueva_raiz;
+        raiz = lista_nodos.read(indice_raiz);
+    }
+}
+
+/*
+compact :: ListaNodo, Int&, Bool, OpcionesArbol -> Void
+Compacta el arbol completo.
+*/
+void compact(ListaNodo &lista_nodos, int &indice_raiz, bool es_Bplus, const OpcionesArbol &opciones) {
+    compact_range(lista_nodos, indice_raiz, numeric_limits<int>::min(), numeric_limits<int>::max(), es_Bplus, opciones);
+}
+
+/*
+relayout :: ListaNodo, Int&, Bool, OpcionesArbol -> Void
+Reubica los nodos del arbol: primero los internos por niveles (la raiz queda en la posicion 0) y despues las hojas
+contiguas en orden de llave, asi una busqueda de rango que sigue la cadena de hojas lee posiciones consecutivas.
+Reescribe los hijos, los enlaces siguiente y anterior de las hojas, los agregados y el indice hash.
+Las posiciones libres desaparecen, porque el arbol queda sin huecos. No se puede usar con copy-on-write.
+*/
+void relayout(ListaNodo &lista_nodos, int &indice_raiz, bool es_Bplus, const OpcionesArbol &opciones) {
+    if (indice_raiz == -1) return;
+    if (opciones.versiones != nullptr)
+        throw runtime_error("relayout: no se puede reubicar un arbol con copy-on-write");
+
+    // Internos por niveles; las hojas aparecen en orden de llave al recorrer cada nivel de izquierda a derecha
+    vector<int> internos, hojas;
+    vector<int> nivel = {indice_raiz};
+    while (!nivel.empty()) {
+        vector<int> siguiente_nivel;
+        for (int idx : nivel) {
+            const Nodo &nodo = lista_nodos.nodes[idx];
+            if (!nodo.es_interno) { hojas.push_back(idx); continue; }
+            internos.push_back(idx);
+            for (int i = 0; i <= nodo.k; ++i)
+                if (nodo.hijos[i] != -1) siguiente_nivel.push_back(nodo.hijos[i]);
+        }
+        nivel.swap(siguiente_nivel);
+    }
+
+    vector<int> nueva_posicion(lista_nodos.size(), -1);
+    int total = 0;
+    for (int idx : internos) nueva_posicion[idx] = total++;
+    for (int idx : hojas) nueva_posicion[idx] = total++;
+
+    ListaNodo reubicada;
+    for (int idx : internos) {
+        Nodo nodo = lista_nodos.read(idx);
+        for (int i = 0; i <= nodo.k; ++i)
+            if (nodo.hijos[i] != -1) nodo.hijos[i] = nueva_posicion[nodo.hijos[i]];
+        reubicada.write(nueva_posicion[idx], nodo);
+    }
+    for (size_t h = 0; h < hojas.size(); ++h) {
+        Nodo hoja = lista_nodos.read(hojas[h]);
+        hoja.siguiente = (h + 1 < hojas.size()) ? nueva_posicion[hojas[h + 1]] : -1;
+        anterior(hoja) = (h > 0) ? nueva_posicion[hojas[h - 1]] : -1;
+        reubicada.write(nueva_posicion[hojas[h]], hoja);
+    }
+    reubicada.reads = lista_nodos.reads;
+    reubicada.writes += lista_nodos.writes;
+
+    if (opciones.agregados != nullptr && es_Bplus) {
+        vector<Resumen> por_nodo(total);
+        for (int idx = 0; idx < (int)nueva_posicion.size(); ++idx)
+            if (nueva_posicion[idx] != -1 && idx < (int)opciones.agregados->por_nodo.size())
+                por_nodo[nueva_posicion[idx]] = opciones.agregados->por_nodo[idx];
+        opciones.agregados->por_nodo.swap(por_nodo);
+    }
+    if (opciones.hash != nullptr && es_Bplus) opciones.hash->remapear(nueva_posicion);
+
+    lista_nodos = std::move(reubicada);
+    indice_raiz = nueva_posicion[indice_raiz];
+}
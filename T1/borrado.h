@@ -0,0 +1,19 @@
+#ifndef BORRADO_H
+#define BORRADO_H
+
+#include "listanodo.h"
+#include "nodo.h"
+#include "btree.h"
+
+/*
+Ocupacion minima bajo la cual la compactacion junta o redistribuye un nodo con un hermano.
+*/
+constexpr int MIN_OCUPACION = B/2 - 1;
+
+int erase(ListaNodo &arr, int root_idx, int key, bool is_Bplus, const OpcionesArbol &options = OpcionesArbol());
+int erase_range(ListaNodo &arr, int root_idx, int l, int u, bool is_Bplus, const OpcionesArbol &options = OpcionesArbol());
+void compact_range(ListaNodo &arr, int &root_idx, int l, int u, bool is_Bplus, const OpcionesArbol &options = OpcionesArbol());
+void compact(ListaNodo &arr, int &root_idx, bool is_Bplus, const OpcionesArbol &options = OpcionesArbol());
+void relayout(ListaNodo &arr, int &root_idx, bool is_Bplus, const OpcionesArbol &options = OpcionesArbol());
+
+#endif
@@ -1,4 +1,5 @@
 #include "btree.h"
+#include "almacen.h"
 #include <stdexcept>
 #include <iostream>
 
@@ -32,17 +33,198 @@ int find_child_index(const Nodo &nodo, int llave) {
     return i;
 }
 
-// split_node :: const Nodo&, bool -> SplitResult
+/*
+hijo_solapa :: Nodo, Int, Int, Int -> Bool
+Indica si el subarbol del hijo i de un nodo interno puede contener llaves en el rango [l, u].
+El hijo i contiene llaves entre pares[i-1].llave y pares[i].llave (ambas inclusive, por las llaves repetidas).
+*/
+bool hijo_solapa(const Nodo &nodo, int i, int l, int u) {
+    if (i > 0 && nodo.pares[i-1].llave > u) return false;
+    if (i < nodo.k && nodo.pares[i].llave < l) return false;
+    return true;
+}
+
+/*
+refresh_summary :: OpcionesArbol, Bool, Int, Nodo -> Void
+Si el arbol lleva agregados, rehace el resumen del nodo idx con su contenido actual.
+*/
+void refresh_summary(const OpcionesArbol &opciones, bool es_Bplus, int idx, const Nodo &nodo) {
+    if (opciones.agregados != nullptr && es_Bplus) opciones.agregados->recalcular(idx, nodo);
+}
+
+/*
+index_leaf :: OpcionesArbol, Bool, Int, Nodo -> Void
+Si el arbol lleva indice hash, apunta a la hoja idx todas sus llaves (cuando sus pares cambiaron de pagina).
+*/
+void index_leaf(const OpcionesArbol &opciones, bool es_Bplus, int idx, const Nodo &nodo) {
+    if (opciones.hash != nullptr && es_Bplus && !nodo.es_interno) opciones.hash->indexar_hoja(idx, nodo);
+}
+
+/*
+append_node :: Almacen, OpcionesArbol, Nodo -> Int
+Agrega un nodo nuevo al arbol; con copy-on-write lo registra en la epoca actual.
+*/
+template <class Almacen>
+int append_node(Almacen &lista_nodos, const OpcionesArbol &opciones, const Nodo &nodo) {
+    int idx = lista_nodos.append(nodo);
+    if (opciones.versiones != nullptr) opciones.versiones->registrar(idx);
+    return idx;
+}
+
+/*
+writable_node :: Almacen, OpcionesArbol, Bool, Int, Nodo -> Int
+Devuelve la posicion donde se puede modificar el nodo idx (cuyo contenido actual es nodo).
+Sin copy-on-write es la misma; con copy-on-write puede ser una copia nueva, que hereda el resumen del original.
+Copy-on-write trabaja sobre ListaNodo (ver VersionesArbol); con otro almacen lanza runtime_error.
+*/
+template <class Almacen>
+int writable_node(Almacen &lista_nodos, const OpcionesArbol &opciones, bool es_Bplus, int idx, const Nodo &nodo) {
+    if (opciones.versiones == nullptr) return idx;
+    if constexpr (!std::is_same<Almacen, ListaNodo>::value) {
+        throw std::runtime_error("Copy-on-write solo esta disponible sobre ListaNodo");
+    } else {
+        int nuevo = opciones.versiones->escribible(lista_nodos, idx, nodo);
+        if (nuevo != idx && opciones.agregados != nullptr && es_Bplus) {
+            Resumen resumen = opciones.agregados->de(idx);
+            opciones.agregados->de(nuevo) = resumen;
+        }
+        if (nuevo != idx) index_leaf(opciones, es_Bplus, nuevo, nodo);
+        return nuevo;
+    }
+}
+
+/*
+link_back :: Almacen, OpcionesArbol, Bool, Int, Int -> Void
+Hace que la hoja indice_hoja apunte hacia atras a indice_anterior. Se usa cuando cambia la hoja que precede
+a una vecina que no se esta modificando (cuesta leer y escribir esa vecina).
+Solo en arboles B+: un arbol B nunca recorre la cadena de hojas, asi que no paga esa lectura y escritura.
+Con copy-on-write no se toca: la vecina puede ser de un snapshot, y ahi los enlaces entre hojas ya no se mantienen
+(ver VersionesArbol::flush).
+*/
+template <class Almacen>
+void link_back(Almacen &lista_nodos, const OpcionesArbol &opciones, bool es_Bplus, int indice_hoja, int indice_anterior) {
+    if (!es_Bplus || indice_hoja == -1 || opciones.versiones != nullptr) return;
+    Nodo hoja = lista_nodos.read(indice_hoja);
+    if (anterior(hoja) == indice_anterior) return;
+    anterior(hoja) = indice_anterior;
+    lista_nodos.write(indice_hoja, hoja);
+}
+
+/*
+purge_tombstones :: Nodo -> Int
+Saca fisicamente las lapidas de una hoja compactando el arreglo de pares.
+Devuelve la cantidad de pares eliminados. En nodos internos no hace nada, porque ahi los pares separan hijos
+(la compactacion de un arbol B los reemplaza, ver purge_internal_tombstones en borrado.cpp).
+*/
+int purge_tombstones(Nodo &nodo) {
+    if (nodo.es_interno) return 0;
+    int j = 0;
+    for (int i = 0; i < nodo.k; ++i)
+        if (!es_lapida(nodo.pares[i])) nodo.pares[j++] = nodo.pares[i];
+    int eliminados = nodo.k - j;
+    nodo.k = j;
+    return eliminados;
+}
+
+/*
+redistribute :: vector<Nodo>, vector<LlaveValor>, Int, Bool -> Reparto
+Junta el contenido de nodos hermanos consecutivos y de los separadores que los dividen en el padre,
+y lo reparte de forma pareja en `partes` nodos nuevos.
+En hojas B+ los separadores son copias y se descartan; el nuevo separador es la ultima llave de cada parte.
+En el resto de los casos los separadores bajan a la secuencia y de ella suben partes-1 separadores nuevos.
+Las lapidas de las hojas se eliminan en el camino. Los enlaces siguiente y anterior quedan a cargo del llamador.
+*/
+Reparto redistribute(const vector<Nodo> &hermanos, const vector<LlaveValor> &separadores, int partes, bool es_Bplus) {
+    bool es_interno = hermanos[0].es_interno;
+    bool hoja_Bplus = es_Bplus && !es_interno;
+    vector<LlaveValor> pares;
+    vector<int> hijos;
+    for (size_t h = 0; h < hermanos.size(); ++h) {
+        const Nodo &nodo = hermanos[h];
+        for (int i = 0; i < nodo.k; ++i) pares.push_back(nodo.pares[i]);
+        if (es_interno) for (int i = 0; i <= nodo.k; ++i) hijos.push_back(nodo.hijos[i]);
+        if (!hoja_Bplus && h + 1 < hermanos.size()) pares.push_back(separadores[h]);
+    }
+    if (!es_interno) {
+        size_t j = 0;
+        for (size_t i = 0; i < pares.size(); ++i) if (!es_lapida(pares[i])) pares[j++] = pares[i];
+        pares.resize(j);
+    }
+
+    int total = (int)pares.size();
+    int repartibles = hoja_Bplus ? total : total - (partes - 1);
+    if (repartibles < 0 || repartibles > partes * B)
+        throw runtime_error("redistribute: el contenido no cabe en la cantidad de partes pedida");
+
+    Reparto reparto;
+    int pos = 0, pos_hijo = 0;
+    for (int p = 0; p < partes; ++p) {
+        Nodo nodo;
+        nodo.es_interno = es_interno;
+        nodo.k = repartibles / partes + (p < repartibles % partes ? 1 : 0);
+        for (int i = 0; i < nodo.k; ++i) nodo.pares[i] = pares[pos++];
+        if (es_interno) for (int i = 0; i <= nodo.k; ++i) nodo.hijos[i] = hijos[pos_hijo++];
+        if (p + 1 < partes) {
+            if (hoja_Bplus) reparto.separadores.push_back(nodo.pares[nodo.k - 1]);
+            else reparto.separadores.push_back(pares[pos++]);
+        }
+        reparto.nodos.push_back(nodo);
+    }
+    return reparto;
+}
+
+/*
+replace_children :: Nodo, Int, Int, vector<Int>, vector<LlaveValor> -> Void
+Reemplaza en el padre los hijos [pos, pos+cantidad) y los cantidad-1 separadores entre ellos
+por los hijos y separadores nuevos, corriendo el resto del arreglo a la izquierda o derecha segun corresponda.
+*/
+void replace_children(Nodo &padre, int pos, int cantidad, const vector<int> &hijos, const vector<LlaveValor> &separadores) {
+    int delta = (int)hijos.size() - cantidad;
+    if (padre.k + delta > B) throw runtime_error("replace_children: el padre no tiene espacio");
+    int fin_viejo = pos + cantidad;
+    if (delta > 0) {
+        for (int i = padre.k; i >= fin_viejo; --i) padre.hijos[i + delta] = padre.hijos[i];
+        for (int i = padre.k - 1; i >= fin_viejo - 1; --i) padre.pares[i + delta] = padre.pares[i];
+    } else if (delta < 0) {
+        for (int i = fin_viejo; i <= padre.k; ++i) padre.hijos[i + delta] = padre.hijos[i];
+        for (int i = fin_viejo - 1; i < padre.k; ++i) padre.pares[i + delta] = padre.pares[i];
+        for (int i = padre.k + delta + 1; i <= padre.k; ++i) padre.hijos[i] = -1;
+    }
+    padre.k += delta;
+    for (size_t i = 0; i < hijos.size(); ++i) padre.hijos[pos + i] = hijos[i];
+    for (size_t i = 0; i < separadores.size(); ++i) padre.pares[pos + i] = separadores[i];
+}
+
+/*
+split_index :: Nodo, Int, Bool, OpcionesArbol, Bool -> Int
+Elige el indice del par medio con que se divide un nodo lleno.
+Por defecto es B/2 - 1. Con SPLIT_APPEND, si el nodo esta en el borde derecho del arbol y la llave que se
+inserta es mayor que todas las del nodo, la pagina izquierda se queda con fraccion_append de los pares,
+ya que con llaves crecientes nunca volvera a recibir inserciones.
+En hojas B+ el medio puede ser el ultimo par (division 100/0); en el resto se deja al menos un par a la derecha
+para que un nodo interno nunca quede sin llaves.
+*/
+int split_index(const Nodo &nodo_full, int llave, bool es_Bplus, const OpcionesArbol &opciones, bool borde_derecho) {
+    int indice_medio = B/2 - 1; //restamos uno ya que la lista empieza de 0
+    if (opciones.split != SPLIT_APPEND || !borde_derecho) return indice_medio;
+    if (llave <= nodo_full.pares[nodo_full.k - 1].llave) return indice_medio;
+
+    int maximo = (!nodo_full.es_interno && es_Bplus) ? nodo_full.k - 1 : nodo_full.k - 2;
+    int indice_append = (int)(nodo_full.k * opciones.fraccion_append) - 1;
+    return max(indice_medio, min(indice_append, maximo));
+}
+
+// split_node :: const Nodo&, bool, Int -> SplitResult
 // Divide un nodo que este con la cantidad maxima de nodos y los separa en dos retornando una estructura SplitResult con los nodos izquierdo, derecho y el par llave-valor del medio.
 // Si es B+ y el nodo es hoja, el par llave-valor del medio se queda en el nodo izquierdo.
-SplitResult split_node(const Nodo &nodo_full, bool es_Bplus) {
+// indice_medio es la posicion del par medio (ver split_index).
+SplitResult split_node(const Nodo &nodo_full, bool es_Bplus, int indice_medio) {
     SplitResult resultado;
     resultado.left = Nodo();
     resultado.right = Nodo();
     resultado.left.es_interno = nodo_full.es_interno;
     resultado.right.es_interno = nodo_full.es_interno;
 
-    int indice_medio = B/2 - 1; //restamos uno ya que la lista empieza de 0
     int indice_izq = 0, indice_der = 0;
 
 
@@ -76,6 +258,12 @@ SplitResult split_node(const Nodo &nodo_full, bool es_Bplus) {
 
     resultado.left.k = indice_izq;
     resultado.right.k = indice_der;
+    // La mitad derecha hereda el enlace a la hoja siguiente y, en un B+, la izquierda el de la anterior;
+    // el llamador enlaza la izquierda con la derecha y la hoja siguiente con la derecha
+    if (!nodo_full.es_interno) {
+        resultado.right.siguiente = nodo_full.siguiente;
+        if (es_Bplus) anterior(resultado.left) = anterior(nodo_full);
+    }
     // Si el nodo es interno, tambien debemos separar los hijos
     if (nodo_full.es_interno) {
         for (int i = 0; i <= indice_medio; ++i) resultado.left.hijos[i] = nodo_full.hijos[i];
@@ -86,24 +274,82 @@ SplitResult split_node(const Nodo &nodo_full, bool es_Bplus) {
     return resultado;
 }
 
-void insert_recursive(ListaNodo &lista_nodos, int indice_nodo, int llave, float valor, bool es_Bplus);
+/*
+split_with_sibling :: Almacen, Int, Nodo, Int, Nodo, Bool, OpcionesArbol -> Void
+Resuelve un hijo lleno al estilo de un arbol B*, usando un hermano adyacente bajo el mismo padre.
+Si algun hermano tiene al menos dos espacios libres, se reparten los pares de ambos de forma pareja (el padre no crece).
+Si no, el hijo y un hermano (de preferencia el derecho) se dividen de 2 en 3 nodos y el padre gana un separador.
+El padre queda escrito en lista_nodos y actualizado en memoria.
+*/
+template <class Almacen>
+void split_with_sibling(Almacen &lista_nodos, int indice_padre, Nodo &padre, int child_rel, const Nodo &child, bool es_Bplus,
+                        const OpcionesArbol &opciones) {
+    // Se busca un hermano con al menos dos espacios libres: con eso el reparto deja ambos nodos con espacio para la insercion
+    int izq = -1;
+    Nodo nodo_izq, nodo_der;
+    if (child_rel > 0) {
+        Nodo hermano = lista_nodos.read(padre.hijos[child_rel - 1]);
+        if (hermano.k < B - 1) { izq = child_rel - 1; nodo_izq = hermano; nodo_der = child; }
+    }
+    if (izq == -1 && child_rel < padre.k) {
+        Nodo hermano = lista_nodos.read(padre.hijos[child_rel + 1]);
+        izq = child_rel; nodo_izq = child; nodo_der = hermano;
+    }
+    if (izq == -1) {
+        // Solo queda el hermano izquierdo y esta lleno
+        izq = child_rel - 1;
+        nodo_izq = lista_nodos.read(padre.hijos[izq]);
+        nodo_der = child;
+    }
 
+    int indice_izq = writable_node(lista_nodos, opciones, es_Bplus, padre.hijos[izq], nodo_izq);
+    int indice_der = writable_node(lista_nodos, opciones, es_Bplus, padre.hijos[izq + 1], nodo_der);
+    int siguiente_der = nodo_der.siguiente;
+    int anterior_izq = anterior(nodo_izq);
+    bool hay_espacio = nodo_izq.k < B - 1 || nodo_der.k < B - 1;
 
+    Reparto reparto = redistribute({nodo_izq, nodo_der}, {padre.pares[izq]}, hay_espacio ? 2 : 3, es_Bplus);
+    vector<int> indices = {indice_izq, indice_der};
+    if (!hay_espacio) indices.push_back(append_node(lista_nodos, opciones, Nodo()));
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (!reparto.nodos[i].es_interno) {
+            reparto.nodos[i].siguiente = (i + 1 < indices.size()) ? indices[i + 1] : siguiente_der;
+            if (es_Bplus) anterior(reparto.nodos[i]) = (i > 0) ? indices[i - 1] : anterior_izq;
+        }
+        lista_nodos.write(indices[i], reparto.nodos[i]);
+        refresh_summary(opciones, es_Bplus, indices[i], reparto.nodos[i]);
+        index_leaf(opciones, es_Bplus, indices[i], reparto.nodos[i]);
+    }
+    if (!nodo_izq.es_interno && !hay_espacio) link_back(lista_nodos, opciones, es_Bplus, siguiente_der, indices.back());
+    replace_children(padre, izq, 2, indices, reparto.separadores);
+    lista_nodos.write(indice_padre, padre);
+}
 
 /*
-insert :: ListaNodo, Int&, Int, Float, Bool -> Void
+insert :: Almacen, Int&, Int, Float, Bool, OpcionesArbol -> Void
 Funcion principal para insertar un par llave-valor en el arbol B o B+.
 Si la raiz esta llena, se divide y se crea una nueva raiz.
 Si no esta llena, se llama a la funcion recursiva insert_recursive para insertar el par en el nodo correspondiente.
+Una raiz hoja llena con lapidas se limpia antes, y solo se divide si sigue llena.
+La raiz siempre esta en el borde derecho del arbol, lo que permite la division por append (ver split_index).
+Con cache de rangos, la llave se saca de los tramos guardados antes de insertar.
 */
-void insert(ListaNodo &lista_nodos, int &indice_raiz, int llave, float valor, bool es_Bplus) {
+template <class Almacen>
+void insert(Almacen &lista_nodos, int &indice_raiz, int llave, float valor, bool es_Bplus, const OpcionesArbol &opciones) {
+    if (opciones.cache != nullptr) opciones.cache->invalidar(llave, llave);
     Nodo raiz = lista_nodos.read(indice_raiz);
+    indice_raiz = writable_node(lista_nodos, opciones, es_Bplus, indice_raiz, raiz);
+    if (raiz.k == B && !raiz.es_interno && purge_tombstones(raiz) > 0) {
+        lista_nodos.write(indice_raiz, raiz);
+    }
     if (raiz.k < B) {
-        insert_recursive(lista_nodos, indice_raiz, llave, valor, es_Bplus);
+        insert_recursive(lista_nodos, indice_raiz, llave, valor, es_Bplus, opciones, true);
     } else {
         //Si la raiz esta llena es decir k=B, se divide con split_node y se crea una nueva raiz
-        SplitResult separados = split_node(raiz, es_Bplus);
-        int indice_der = lista_nodos.append(separados.right);
+        SplitResult separados = split_node(raiz, es_Bplus, split_index(raiz, llave, es_Bplus, opciones, true));
+        if (es_Bplus && !separados.left.es_interno) anterior(separados.right) = indice_raiz;
+        int indice_der = append_node(lista_nodos, opciones, separados.right);
+        if (!separados.left.es_interno) separados.left.siguiente = indice_der;
         lista_nodos.write(indice_raiz, separados.left);
         
         //Iniciamos la nueva raiz con los valores correspondientes
@@ -116,65 +362,127 @@ void insert(ListaNodo &lista_nodos, int &indice_raiz, int llave, float valor, bo
         nueva_raiz.hijos[1] = indice_der;
 
 
-        indice_raiz = lista_nodos.append(nueva_raiz);
+        indice_raiz = append_node(lista_nodos, opciones, nueva_raiz);
+        refresh_summary(opciones, es_Bplus, nueva_raiz.hijos[0], separados.left);
+        refresh_summary(opciones, es_Bplus, indice_der, separados.right);
+        refresh_summary(opciones, es_Bplus, indice_raiz, nueva_raiz);
+        index_leaf(opciones, es_Bplus, indice_der, separados.right);
+        if (opciones.agregados != nullptr && es_Bplus) opciones.agregados->de(indice_raiz).agregar(valor);
 
         //Ahora insertamos el par llave-valor en el nodo izquierdo o derecho segun corresponde
         if (llave <= separados.med_llave){
-            insert_recursive(lista_nodos, nueva_raiz.hijos[0], llave, valor, es_Bplus);
+            insert_recursive(lista_nodos, nueva_raiz.hijos[0], llave, valor, es_Bplus, opciones, false);
         }
         else {
-            insert_recursive(lista_nodos, nueva_raiz.hijos[1], llave, valor, es_Bplus);
+            insert_recursive(lista_nodos, nueva_raiz.hijos[1], llave, valor, es_Bplus, opciones, true);
         }
     }
 }
 
 
 /*
-insert_recursive :: ListaNodo, Int, Int, Float, Bool -> Void
+insert_recursive :: Almacen, Int, Int, Float, Bool, OpcionesArbol, Bool -> Void
 Funcion recursiva que se encarga de insertar un par llave-valor en el nodo correspondiente
 Si el nodo es hoja y tiene espacio, se inserta el par directamente.
 Si el nodo es hoja y no tiene espacio, se divide el nodo y se inserta el par en el nodo correspondiente.
 Si el nodo es interno, se busca el hijo correspondiente y se llama recursivamente a insert_recursive.
+borde_derecho indica si el nodo es el ultimo de su nivel (todos sus ancestros bajaron por el ultimo hijo).
+Con agregados, el valor se suma al resumen de cada nodo del camino antes de bajar.
 */
-void insert_recursive(ListaNodo &lista_nodos, int indice_nodo, int llave, float valor, bool es_Bplus) {
+template <class Almacen>
+void insert_recursive(Almacen &lista_nodos, int indice_nodo, int llave, float valor, bool es_Bplus,
+                      const OpcionesArbol &opciones, bool borde_derecho) {
 
     Nodo nodo_actual = lista_nodos.read(indice_nodo);
+    if (opciones.agregados != nullptr && es_Bplus) opciones.agregados->de(indice_nodo).agregar(valor);
     // Vemos si estamos en una hoja
     if (!nodo_actual.es_interno) {
         // Si el nodo tiene espacio insertamos el par directamente, sino se separa el nodo en dos y se actualiza "el arbol" con los cambios.
         if (nodo_actual.k < B) {
             insert_pair_in_node(nodo_actual, llave, valor);
             lista_nodos.write(indice_nodo, nodo_actual);
+            if (opciones.hash != nullptr && es_Bplus) {
+                int ranura = 0;
+                while (nodo_actual.pares[ranura].llave < llave) ranura++;
+                opciones.hash->asignar(llave, indice_nodo, ranura);
+            }
         } else {
-            SplitResult separados = split_node(nodo_actual, es_Bplus);
-            int indice_der = lista_nodos.append(separados.right);
+            SplitResult separados = split_node(nodo_actual, es_Bplus, split_index(nodo_actual, llave, es_Bplus, opciones, borde_derecho));
+            if (es_Bplus) anterior(separados.right) = indice_nodo;
+            int indice_der = append_node(lista_nodos, opciones, separados.right);
             separados.left.siguiente = indice_der;
             lista_nodos.write(indice_nodo, separados.left);
+            link_back(lista_nodos, opciones, es_Bplus, separados.right.siguiente, indice_der);
+            index_leaf(opciones, es_Bplus, indice_der, separados.right);
         }
     } else {
         int child_rel = find_child_index(nodo_actual, llave);
         int child_idx = nodo_actual.hijos[child_rel];
+        bool child_borde = borde_derecho && child_rel == nodo_actual.k;
         // Si el hijo no existe, se crea uno nuevo y se inserta el par ahi.
         if (child_idx == -1) {
             Nodo nuevo;
-            int nuevo_idx = lista_nodos.append(nuevo);
+            int nuevo_idx = append_node(lista_nodos, opciones, nuevo);
             nodo_actual.hijos[child_rel] = nuevo_idx;
             lista_nodos.write(indice_nodo, nodo_actual);
-            insert_recursive(lista_nodos, nuevo_idx, llave, valor, es_Bplus);
+            insert_recursive(lista_nodos, nuevo_idx, llave, valor, es_Bplus, opciones, child_borde);
         } else {
             Nodo child = lista_nodos.read(child_idx);
-            if (child.k == B) {
-                SplitResult separados = split_node(child, es_Bplus);
-                int indice_der = lista_nodos.append(separados.right);
+            // Con copy-on-write todo el camino se copia: el hijo se mueve a una pagina escribible y el padre apunta a ella
+            int child_escribible = writable_node(lista_nodos, opciones, es_Bplus, child_idx, child);
+            if (child_escribible != child_idx) {
+                child_idx = child_escribible;
+                nodo_actual.hijos[child_rel] = child_idx;
+                lista_nodos.write(indice_nodo, nodo_actual);
+            }
+            // Una hoja llena con lapidas se limpia antes de dividirla, asi el espacio borrado se reutiliza
+            if (child.k == B && !child.es_interno && purge_tombstones(child) > 0) {
+                lista_nodos.write(child_idx, child);
+            }
+            int indice_medio = (child.k == B) ? split_index(child, llave, es_Bplus, opciones, child_borde) : -1;
+            bool es_append = indice_medio != B/2 - 1;
+            if (child.k == B && opciones.redistribuir_hermanos && !es_append && nodo_actual.k > 0) {
+                // Estilo B*: se reparte con un hermano y se vuelve a elegir el hijo, que ahora tiene espacio
+                split_with_sibling(lista_nodos, indice_nodo, nodo_actual, child_rel, child, es_Bplus, opciones);
+                child_rel = find_child_index(nodo_actual, llave);
+                insert_recursive(lista_nodos, nodo_actual.hijos[child_rel], llave, valor, es_Bplus, opciones,
+                                 borde_derecho && child_rel == nodo_actual.k);
+            } else if (child.k == B) {
+                SplitResult separados = split_node(child, es_Bplus, indice_medio);
+                if (es_Bplus && !separados.left.es_interno) anterior(separados.right) = child_idx;
+                int indice_der = append_node(lista_nodos, opciones, separados.right);
+                if (!separados.left.es_interno) {
+                    separados.left.siguiente = indice_der;
+                    link_back(lista_nodos, opciones, es_Bplus, separados.right.siguiente, indice_der);
+                }
                 lista_nodos.write(child_idx, separados.left);
+                refresh_summary(opciones, es_Bplus, child_idx, separados.left);
+                refresh_summary(opciones, es_Bplus, indice_der, separados.right);
+                index_leaf(opciones, es_Bplus, indice_der, separados.right);
                 insert_pair_in_node(nodo_actual, separados.med_llave, separados.med_valor);
                 for (int i = nodo_actual.k; i > child_rel+1; --i)
                     nodo_actual.hijos[i] = nodo_actual.hijos[i-1];
                 nodo_actual.hijos[child_rel+1] = indice_der;
                 lista_nodos.write(indice_nodo, nodo_actual);
-                if (llave <= separados.med_llave) insert_recursive(lista_nodos, child_idx, llave, valor, es_Bplus);
-                else insert_recursive(lista_nodos, indice_der, llave, valor, es_Bplus);
-            } else insert_recursive(lista_nodos, child_idx, llave, valor, es_Bplus);
+                if (llave <= separados.med_llave) insert_recursive(lista_nodos, child_idx, llave, valor, es_Bplus, opciones, false);
+                else insert_recursive(lista_nodos, indice_der, llave, valor, es_Bplus, opciones, child_borde);
+            } else insert_recursive(lista_nodos, child_idx, llave, valor, es_Bplus, opciones, child_borde);
         }
     }
-}
\ No newline at end of file
+}
+
+/*
+Instancias de la insercion para cada almacen (ver almacen.h).
+*/
+#define INSTANCIAR_INSERCION(Almacen) \
+    template int append_node<Almacen>(Almacen &, const OpcionesArbol &, const Nodo &); \
+    template int writable_node<Almacen>(Almacen &, const OpcionesArbol &, bool, int, const Nodo &); \
+    template void link_back<Almacen>(Almacen &, const OpcionesArbol &, bool, int, int); \
+    template void split_with_sibling<Almacen>(Almacen &, int, Nodo &, int, const Nodo &, bool, const OpcionesArbol &); \
+    template void insert<Almacen>(Almacen &, int &, int, float, bool, const OpcionesArbol &); \
+    template void insert_recursive<Almacen>(Almacen &, int, int, float, bool, const OpcionesArbol &, bool);
+
+INSTANCIAR_INSERCION(ListaNodo)
+INSTANCIAR_INSERCION(AlmacenArchivo)
+INSTANCIAR_INSERCION(AlmacenCache)
+INSTANCIAR_INSERCION(AlmacenMmap)
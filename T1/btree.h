@@ -3,6 +3,40 @@
 
 #include "listanodo.h"
 #include "nodo.h"
+#include "agregados.h"
+#include "versiones.h"
+#include "indicehash.h"
+#include "cacherango.h"
+
+/*
+PoliticaSplit :: enum
+SPLIT_MITAD divide los nodos llenos por la mitad.
+SPLIT_APPEND detecta inserciones al final del arbol (llaves crecientes, como timestamps) y deja la pagina izquierda llena.
+*/
+enum PoliticaSplit { SPLIT_MITAD, SPLIT_APPEND };
+
+/*
+OpcionesArbol :: struct
+Configuracion de un arbol que se pasa a las funciones de insercion.
+fraccion_append es la fraccion de pares que se queda en la pagina izquierda en una division por append (1.0 = 100/0, 0.9 = 90/10).
+redistribuir_hermanos activa el comportamiento de arbol B*: antes de dividir un hijo lleno se le pasan pares a un
+hermano con espacio, y si los dos estan llenos se dividen de 2 en 3 (ocupacion minima cercana a 2/3 en vez de 1/2).
+agregados, si no es nulo, recibe el resumen (cantidad/suma/min/max) del subarbol de cada nodo. Solo se usa en arboles B+.
+versiones, si no es nulo, hace que la insercion sea copy-on-write para no alterar los snapshots fijados (ver VersionesArbol).
+En ese modo los enlaces siguiente y anterior entre hojas no se mantienen: VersionesArbol::flush marca el archivo y las
+busquedas que siguen la cadena de hojas lanzan runtime_error; las consultas deben bajar por el arbol (range_search_tree_disk).
+hash, si no es nulo, se mantiene con la hoja de cada llave para busquedas exactas con get. Solo se usa en arboles B+.
+cache, si no es nulo, pierde los tramos que cubren cada llave insertada o borrada (ver CacheRangos).
+*/
+struct OpcionesArbol {
+    PoliticaSplit split = SPLIT_MITAD;
+    double fraccion_append = 1.0;
+    bool redistribuir_hermanos = false;
+    Agregados *agregados = nullptr;
+    VersionesArbol *versiones = nullptr;
+    IndiceHash *hash = nullptr;
+    CacheRangos *cache = nullptr;
+};
 
 void insert_pair_in_node(Nodo &node, int key, float val);
 int find_child_index(const Nodo &node, int key);
@@ -19,8 +53,36 @@ struct SplitResult {
     float med_valor;
 };
 
-SplitResult split_node(const Nodo &full, bool is_Bplus);
-void insert(ListaNodo &arr, int &root_idx, int key, float val, bool is_Bplus);
-void insert_recursive(ListaNodo &arr, int node_idx, int key, float val, bool is_Bplus);
+/*
+Reparto :: struct
+Resultado de redistribuir el contenido de nodos hermanos: los nodos nuevos y los separadores que van entre ellos en el padre.
+*/
+struct Reparto {
+    std::vector<Nodo> nodos;
+    std::vector<LlaveValor> separadores;
+};
+
+bool hijo_solapa(const Nodo &node, int i, int l, int u);
+void refresh_summary(const OpcionesArbol &options, bool is_Bplus, int idx, const Nodo &node);
+template <class Almacen>
+int append_node(Almacen &arr, const OpcionesArbol &options, const Nodo &node);
+template <class Almacen>
+int writable_node(Almacen &arr, const OpcionesArbol &options, bool is_Bplus, int idx, const Nodo &node);
+template <class Almacen>
+void link_back(Almacen &arr, const OpcionesArbol &options, bool is_Bplus, int leaf_idx, int prev_idx);
+void index_leaf(const OpcionesArbol &options, bool is_Bplus, int idx, const Nodo &node);
+int purge_tombstones(Nodo &node);
+Reparto redistribute(const std::vector<Nodo> &siblings, const std::vector<LlaveValor> &separators, int parts, bool is_Bplus);
+void replace_children(Nodo &parent, int pos, int count, const std::vector<int> &children, const std::vector<LlaveValor> &separators);
+int split_index(const Nodo &full, int key, bool is_Bplus, const OpcionesArbol &options, bool right_edge);
+SplitResult split_node(const Nodo &full, bool is_Bplus, int mid_idx = B/2 - 1);
+template <class Almacen>
+void split_with_sibling(Almacen &arr, int parent_idx, Nodo &parent, int child_rel, const Nodo &child, bool is_Bplus,
+                        const OpcionesArbol &options = OpcionesArbol());
+template <class Almacen>
+void insert(Almacen &arr, int &root_idx, int key, float val, bool is_Bplus, const OpcionesArbol &options = OpcionesArbol());
+template <class Almacen>
+void insert_recursive(Almacen &arr, int node_idx, int key, float val, bool is_Bplus,
+                      const OpcionesArbol &options = OpcionesArbol(), bool right_edge = false);
 
 #endif
@@ -1,46 +1,96 @@
 #include "busqueda.h"
 #include "btree.h"
+#include "almacen.h"
 #include <stdexcept>
 #include <iostream>
 
 /*
-range_search_B_disk :: DiskManager, Int, Int, Int, vector<pair<Int,Float>>& -> Void
-Realiza una busqueda de rango en un arbol B almacenado en disco.
+range_search_B :: Almacen, Int, Int, Int, vector<pair<Int,Float>>&, Int& -> Void
+Realiza una busqueda de rango en un arbol B guardado en cualquier almacen (ver almacen.h), en orden de llave.
+Solo baja a los hijos que se solapan con [l, u], y junta tambien los pares de los nodos internos, que en un arbol B son datos.
+Los pares marcados como lapida se saltan.
 */
-void range_search_B_disk(DiskManager &disck_manager, int node_idx, int l, int u, vector<pair<int,float>> &out, int &io_busquedas) {
+template <class Almacen>
+void range_search_B(Almacen &almacen, int node_idx, int l, int u, vector<pair<int,float>> &out, int &io_busquedas) {
     if (node_idx == -1) return;
     io_busquedas++;
-    Nodo node = disck_manager.read_node_at(node_idx);
+    Nodo node = almacen.read(node_idx);
     if (!node.es_interno) {
         for (int i = 0; i < node.k; ++i)
-            if (node.pares[i].llave >= l && node.pares[i].llave <= u)
+            if (node.pares[i].llave >= l && node.pares[i].llave <= u && !es_lapida(node.pares[i]))
                 out.emplace_back(node.pares[i].llave, node.pares[i].valor);
     } else {
-        for (int i = 0; i <= node.k; ++i)
-            if (node.hijos[i] != -1)
-                range_search_B_disk(disck_manager, node.hijos[i], l, u, out, io_busquedas);
+        for (int i = 0; i <= node.k; ++i) {
+            if (node.hijos[i] != -1 && hijo_solapa(node, i, l, u))
+                range_search_B(almacen, node.hijos[i], l, u, out, io_busquedas);
+            if (i < node.k && node.pares[i].llave >= l && node.pares[i].llave <= u && !es_lapida(node.pares[i]))
+                out.emplace_back(node.pares[i].llave, node.pares[i].valor);
+        }
     }
 }
 
 /*
-range_search_Bplus_disk :: DiskManager, Int, Int, Int -> vector<pair<Int,Float>>
-Realiza una busqueda de rango en un arbol B+ almacenado en disco.
+range_search_B_disk :: DiskManager, Int, Int, Int, vector<pair<Int,Float>>& -> Void
+range_search_B sobre un arbol B almacenado en disco.
 */
-vector<pair<int,float>> range_search_Bplus_disk(DiskManager &disck_manager, int indice_raiz, int l, int u, int &io_busquedas) {
+void range_search_B_disk(DiskManager &disck_manager, int node_idx, int l, int u, vector<pair<int,float>> &out, int &io_busquedas) {
+    range_search_B(disck_manager, node_idx, l, u, out, io_busquedas);
+}
+
+/*
+range_search_B_disk_paralelo :: DiskManager, Int, Int, Int, vector<pair<Int,Float>>&, Int&, Int -> Void
+Igual que range_search_B_disk, pero los hijos que se solapan con [l, u] se piden a la cola de lecturas del DiskManager
+(hasta profundidad_cola en vuelo) y cada nodo se procesa apenas se completa su lectura, pidiendo de inmediato sus hijos,
+sin esperar al resto de su nivel. Lee los mismos nodos que la version recursiva. Al final ordena los resultados por llave.
+*/
+void range_search_B_disk_paralelo(DiskManager &disck_manager, int node_idx, int l, int u, vector<pair<int,float>> &out,
+                                  int &io_busquedas, int profundidad_cola) {
+    if (node_idx == -1) return;
+    size_t inicio = out.size();
+    disck_manager.pedir_lectura(node_idx, node_idx, profundidad_cola);
+    int pendientes = 1;
+    while (pendientes > 0) {
+        LecturaCompletada lectura = disck_manager.esperar_lectura();
+        pendientes--;
+        io_busquedas++;
+        const Nodo &node = lectura.nodo;
+        for (int i = 0; i < node.k; ++i)
+            if (node.pares[i].llave >= l && node.pares[i].llave <= u && !es_lapida(node.pares[i]))
+                out.emplace_back(node.pares[i].llave, node.pares[i].valor);
+        if (!node.es_interno) continue;
+        for (int i = 0; i <= node.k; ++i) {
+            if (node.hijos[i] != -1 && hijo_solapa(node, i, l, u)) {
+                disck_manager.pedir_lectura(node.hijos[i], node.hijos[i], profundidad_cola);
+                pendientes++;
+            }
+        }
+    }
+    stable_sort(out.begin() + inicio, out.end(),
+                [](const pair<int,float> &a, const pair<int,float> &b) { return a.first < b.first; });
+}
+
+/*
+range_search_Bplus :: Almacen, Int, Int, Int, Int& -> vector<pair<Int,Float>>
+Realiza una busqueda de rango en un arbol B+ guardado en cualquier almacen (ver almacen.h).
+Baja hasta la hoja donde empieza el rango y recorre la cadena de hojas saltandose las lapidas.
+*/
+template <class Almacen>
+vector<pair<int,float>> range_search_Bplus(Almacen &almacen, int indice_raiz, int l, int u, int &io_busquedas) {
     if (indice_raiz == -1) return {};
     int indice_actual = indice_raiz;
     while (true) {
         io_busquedas++;
-        Nodo node = disck_manager.read_node_at(indice_actual);
+        Nodo node = almacen.read(indice_actual);
         if (!node.es_interno) {
             vector<pair<int,float>> out;
             int indice_iterador = indice_actual;
             while (indice_iterador != -1) {
                 io_busquedas++;
-                Nodo hoja = disck_manager.read_node_at(indice_iterador);
+                Nodo hoja = almacen.read(indice_iterador);
                 for (int i = 0; i < hoja.k; ++i) {
-                    if (hoja.pares[i].llave >= l && hoja.pares[i].llave <= u)
-                        out.emplace_back(hoja.pares[i].llave, hoja.pares[i].valor);
+                    if (hoja.pares[i].llave >= l && hoja.pares[i].llave <= u) {
+                        if (!es_lapida(hoja.pares[i])) out.emplace_back(hoja.pares[i].llave, hoja.pares[i].valor);
+                    }
                     else if (hoja.pares[i].llave > u)
                         return out;
                 }
@@ -52,4 +102,225 @@ vector<pair<int,float>> range_search_Bplus_disk(DiskManager &disck_manager, int
             indice_actual = node.hijos[child];
         }
     }
-}
\ No newline at end of file
+}
+
+/*
+range_search_Bplus_disk :: DiskManager, Int, Int, Int -> vector<pair<Int,Float>>
+range_search_Bplus sobre un arbol B+ almacenado en disco.
+Lanza runtime_error si el archivo no mantiene la cadena de hojas (ver Superbloque::hojas_enlazadas).
+*/
+vector<pair<int,float>> range_search_Bplus_disk(DiskManager &disck_manager, int indice_raiz, int l, int u, int &io_busquedas) {
+    disck_manager.exigir_hojas_enlazadas();
+    return range_search_Bplus(disck_manager, indice_raiz, l, u, io_busquedas);
+}
+
+/*
+aggregate_node :: DiskManager, Int, Int64, Int64, Int, Int, Resumen&, Int& -> Void
+Acumula en out el resumen de los pares con llave en [l, u] del subarbol del nodo, cuyo rango de llaves es [lo, hi].
+Los hijos que quedan completamente dentro de [l, u] se resuelven con el bloque de resumenes del nodo, sin leerlos;
+solo se baja por los (a lo mas dos) hijos que cortan los bordes del rango.
+*/
+static void aggregate_node(DiskManager &disck_manager, int node_idx, long long lo, long long hi, int l, int u, Resumen &out, int &io_busquedas) {
+    io_busquedas++;
+    Nodo node = disck_manager.read_node_at(node_idx);
+    if (!node.es_interno) {
+        for (int i = 0; i < node.k; ++i)
+            if (node.pares[i].llave >= l && node.pares[i].llave <= u && !es_lapida(node.pares[i]))
+                out.agregar(node.pares[i].valor);
+        return;
+    }
+    bool bloque_leido = false;
+    BloqueResumen bloque;
+    for (int i = 0; i <= node.k; ++i) {
+        if (!hijo_solapa(node, i, l, u) || node.hijos[i] == -1) continue;
+        long long lo_hijo = (i > 0) ? node.pares[i-1].llave : lo;
+        long long hi_hijo = (i < node.k) ? node.pares[i].llave : hi;
+        if (lo_hijo >= l && hi_hijo <= u) {
+            if (!bloque_leido) {
+                bloque = disck_manager.read_summary_block(node.siguiente);
+                io_busquedas += Paginas_bloque_resumen;
+                bloque_leido = true;
+            }
+            out.combinar(bloque.hijos[i]);
+        } else {
+            aggregate_node(disck_manager, node.hijos[i], lo_hijo, hi_hijo, l, u, out, io_busquedas);
+        }
+    }
+}
+
+/*
+range_aggregate_Bplus_disk :: DiskManager, Int, Int, Int, Int& -> Resumen
+Calcula cantidad, suma, minimo y maximo de los valores con llave en [l, u] de un arbol B+ escrito con agregados.
+Lee O(altura) paginas en vez de recorrer todas las hojas del rango como range_search_Bplus_disk.
+*/
+Resumen range_aggregate_Bplus_disk(DiskManager &disck_manager, int indice_raiz, int l, int u, int &io_busquedas) {
+    Resumen out;
+    if (indice_raiz == -1 || l > u) return out;
+    aggregate_node(disck_manager, indice_raiz, numeric_limits<long long>::min(), numeric_limits<long long>::max(), l, u, out, io_busquedas);
+    return out;
+}
+
+/*
+zone_search_node :: DiskManager, Int, Int, Int, Float, Float, vector<pair<Int,Float>>&, Int& -> Void
+Recorre el subarbol del nodo bajando solo por los hijos que se solapan con [l, u] en la llave y cuyo
+mapa de zona (minimo y maximo de valor del bloque de resumenes) puede tener valores en [vmin, vmax].
+*/
+static void zone_search_node(DiskManager &disck_manager, int node_idx, int l, int u, float vmin, float vmax,
+                             vector<pair<int,float>> &out, int &io_busquedas) {
+    io_busquedas++;
+    Nodo node = disck_manager.read_node_at(node_idx);
+    if (!node.es_interno) {
+        for (int i = 0; i < node.k; ++i) {
+            const LlaveValor &par = node.pares[i];
+            if (par.llave >= l && par.llave <= u && !es_lapida(par) && par.valor >= vmin && par.valor <= vmax)
+                out.emplace_back(par.llave, par.valor);
+        }
+        return;
+    }
+    io_busquedas += Paginas_bloque_resumen;
+    BloqueResumen bloque = disck_manager.read_summary_block(node.siguiente);
+    for (int i = 0; i <= node.k; ++i) {
+        if (!hijo_solapa(node, i, l, u) || node.hijos[i] == -1) continue;
+        const Resumen &zona = bloque.hijos[i];
+        if (zona.cantidad == 0 || zona.maximo < vmin || zona.minimo > vmax) continue;
+        zone_search_node(disck_manager, node.hijos[i], l, u, vmin, vmax, out, io_busquedas);
+    }
+}
+
+/*
+range_search_Bplus_disk :: DiskManager, Int, Int, Int, Float, Float, Int& -> vector<pair<Int,Float>>
+Busqueda de rango en la llave con filtro de valor: devuelve los pares con llave en [l, u] y valor en [vmin, vmax].
+Usa el minimo y maximo de cada hijo guardados en el archivo de agregados como mapa de zona, asi que solo se leen
+las hojas que pueden tener resultados. El arbol debe haberse escrito con agregados (ver DiskManager::write_all).
+*/
+vector<pair<int,float>> range_search_Bplus_disk(DiskManager &disck_manager, int indice_raiz, int l, int u, float vmin, float vmax,
+                                                int &io_busquedas) {
+    vector<pair<int,float>> out;
+    if (indice_raiz == -1 || l > u || vmin > vmax) return out;
+    zone_search_node(disck_manager, indice_raiz, l, u, vmin, vmax, out, io_busquedas);
+    return out;
+}
+
+/*
+tree_search_node :: DiskManager, Int, Int, Int, vector<pair<Int,Float>>&, Int& -> Void
+Recorre en orden los hijos del nodo que se solapan con [l, u] y junta los pares de las hojas.
+*/
+static void tree_search_node(DiskManager &disck_manager, int node_idx, int l, int u, vector<pair<int,float>> &out, int &io_busquedas) {
+    io_busquedas++;
+    Nodo node = disck_manager.read_node_at(node_idx);
+    if (!node.es_interno) {
+        for (int i = 0; i < node.k; ++i)
+            if (node.pares[i].llave >= l && node.pares[i].llave <= u && !es_lapida(node.pares[i]))
+                out.emplace_back(node.pares[i].llave, node.pares[i].valor);
+        return;
+    }
+    for (int i = 0; i <= node.k; ++i)
+        if (node.hijos[i] != -1 && hijo_solapa(node, i, l, u))
+            tree_search_node(disck_manager, node.hijos[i], l, u, out, io_busquedas);
+}
+
+/*
+range_search_tree_disk :: DiskManager, Int, Int, Int, Int& -> vector<pair<Int,Float>>
+Busqueda de rango en un arbol B+ bajando por el arbol en vez de seguir la cadena de hojas.
+Es la que se usa sobre un snapshot copy-on-write, donde los enlaces siguiente pueden apuntar a paginas de otra version.
+Lee las mismas hojas que range_search_Bplus_disk mas los nodos internos que cubren el rango.
+*/
+vector<pair<int,float>> range_search_tree_disk(DiskManager &disck_manager, int indice_raiz, int l, int u, int &io_busquedas) {
+    vector<pair<int,float>> out;
+    if (indice_raiz == -1 || l > u) return out;
+    tree_search_node(disck_manager, indice_raiz, l, u, out, io_busquedas);
+    return out;
+}
+
+/*
+actual :: -> pair<Int,Float>
+Par en la posicion actual del cursor.
+*/
+pair<int,float> CursorInverso::actual() const {
+    return {hoja.pares[pos].llave, hoja.pares[pos].valor};
+}
+
+/*
+acomodar :: -> Void
+Deja el cursor en un par valido: se salta las lapidas y, si la hoja se acabo, pasa a la hoja anterior.
+Si no quedan hojas, pos queda en -1.
+*/
+void CursorInverso::acomodar() {
+    while (true) {
+        while (pos >= 0 && es_lapida(hoja.pares[pos])) pos--;
+        if (pos >= 0 || anterior(hoja) == -1) return;
+        (*io_busquedas)++;
+        hoja = dm->read_node_at(anterior(hoja));
+        pos = hoja.k - 1;
+    }
+}
+
+/*
+retroceder :: -> Void
+Mueve el cursor al par anterior (de llave menor o igual).
+*/
+void CursorInverso::retroceder() {
+    pos--;
+    acomodar();
+}
+
+/*
+cursor_inverso_Bplus_disk :: DiskManager, Int, Int, Int& -> CursorInverso
+Baja una vez por el arbol hasta la hoja que contiene la mayor llave <= t (eligiendo en cada nodo el primer
+hijo cuyo separador es mayor que t) y deja el cursor en ese par.
+Lanza runtime_error si el archivo no mantiene la cadena de hojas (ver Superbloque::hojas_enlazadas).
+*/
+CursorInverso cursor_inverso_Bplus_disk(DiskManager &disck_manager, int indice_raiz, int t, int &io_busquedas) {
+    disck_manager.exigir_hojas_enlazadas();
+    CursorInverso cursor;
+    cursor.dm = &disck_manager;
+    cursor.io_busquedas = &io_busquedas;
+    if (indice_raiz == -1) return cursor;
+    int indice_actual = indice_raiz;
+    while (true) {
+        io_busquedas++;
+        Nodo node = disck_manager.read_node_at(indice_actual);
+        if (!node.es_interno) {
+            cursor.hoja = node;
+            int i = 0;
+            while (i < node.k && node.pares[i].llave <= t) ++i;
+            cursor.pos = i - 1;
+            cursor.acomodar();
+            return cursor;
+        }
+        int i = 0;
+        while (i < node.k && node.pares[i].llave <= t) ++i;
+        indice_actual = node.hijos[i];
+    }
+}
+
+/*
+last_n_Bplus_disk :: DiskManager, Int, Int, Int, Int& -> vector<pair<Int,Float>>
+Devuelve los ultimos n pares con llave <= t, ordenados por llave.
+Baja una sola vez y recorre las hojas de derecha a izquierda; no lee la hoja anterior una vez que tiene los n pares.
+*/
+vector<pair<int,float>> last_n_Bplus_disk(DiskManager &disck_manager, int indice_raiz, int t, int n, int &io_busquedas) {
+    vector<pair<int,float>> out;
+    if (n <= 0) return out;
+    CursorInverso cursor = cursor_inverso_Bplus_disk(disck_manager, indice_raiz, t, io_busquedas);
+    while (cursor.valido()) {
+        out.push_back(cursor.actual());
+        if ((int)out.size() == n) break;
+        cursor.retroceder();
+    }
+    reverse(out.begin(), out.end());
+    return out;
+}
+
+/*
+Instancias de la busqueda para cada almacen (ver almacen.h); DiskManager solo se lee.
+*/
+#define INSTANCIAR_BUSQUEDA(Almacen) \
+    template void range_search_B<Almacen>(Almacen &, int, int, int, vector<pair<int,float>> &, int &); \
+    template vector<pair<int,float>> range_search_Bplus<Almacen>(Almacen &, int, int, int, int &);
+
+INSTANCIAR_BUSQUEDA(DiskManager)
+INSTANCIAR_BUSQUEDA(ListaNodo)
+INSTANCIAR_BUSQUEDA(AlmacenArchivo)
+INSTANCIAR_BUSQUEDA(AlmacenCache)
+INSTANCIAR_BUSQUEDA(AlmacenMmap)
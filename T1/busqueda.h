@@ -3,7 +3,42 @@
 
 #include "manejodisco.h"
 
+/*
+Lecturas en vuelo por defecto de la busqueda de rango paralela en arboles B.
+*/
+constexpr int Profundidad_cola_por_defecto = 8;
+
+template <class Almacen>
+void range_search_B(Almacen &almacen, int node_idx, int l, int u, std::vector<std::pair<int,float>> &out, int &io_busquedas);
+template <class Almacen>
+std::vector<std::pair<int,float>> range_search_Bplus(Almacen &almacen, int root_idx, int l, int u, int &io_busquedas);
+
 void range_search_B_disk(DiskManager &dm, int node_idx, int l, int u, std::vector<std::pair<int,float>> &out, int &io_busquedas);
+void range_search_B_disk_paralelo(DiskManager &dm, int node_idx, int l, int u, std::vector<std::pair<int,float>> &out,
+                                  int &io_busquedas, int queue_depth = Profundidad_cola_por_defecto);
 std::vector<std::pair<int,float>> range_search_Bplus_disk(DiskManager &dm, int root_idx, int l, int u, int &io_busquedas);
+std::vector<std::pair<int,float>> range_search_Bplus_disk(DiskManager &dm, int root_idx, int l, int u, float vmin, float vmax, int &io_busquedas);
+std::vector<std::pair<int,float>> range_search_tree_disk(DiskManager &dm, int root_idx, int l, int u, int &io_busquedas);
+Resumen range_aggregate_Bplus_disk(DiskManager &dm, int root_idx, int l, int u, int &io_busquedas);
+
+/*
+CursorInverso :: struct
+Recorre de mayor a menor llave los pares de un arbol B+ en disco siguiendo los enlaces anterior de las hojas,
+saltandose las lapidas. Solo lee una hoja cuando hace falta su primer par, y cada lectura suma uno a io_busquedas.
+*/
+struct CursorInverso {
+    DiskManager *dm = nullptr;
+    int *io_busquedas = nullptr;
+    Nodo hoja;
+    int pos = -1;
+
+    bool valido() const { return pos >= 0; }
+    std::pair<int,float> actual() const;
+    void retroceder();
+    void acomodar();
+};
+
+CursorInverso cursor_inverso_Bplus_disk(DiskManager &dm, int root_idx, int t, int &io_busquedas);
+std::vector<std::pair<int,float>> last_n_Bplus_disk(DiskManager &dm, int root_idx, int t, int n, int &io_busquedas);
 
 #endif
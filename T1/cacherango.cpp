@@ -0,0 +1,142 @@
+#include "cacherango.h"
+#include "busqueda.h"
+using namespace std;
+
+/*
+primer_solapado :: map<Int,Tramo>, Int64 -> iterator
+Primer tramo que termina en desde o despues (el unico que puede empezar antes de desde y cubrirlo).
+*/
+static map<int, CacheRangos::Tramo>::iterator primer_solapado(map<int, CacheRangos::Tramo> &tramos, long long desde) {
+    auto it = tramos.upper_bound((int)max<long long>(desde, numeric_limits<int>::min()));
+    if (it != tramos.begin() && prev(it)->second.u >= desde) --it;
+    return it;
+}
+
+/*
+tocar :: iterator -> Void
+Marca el tramo como el usado mas recientemente (lo pasa al frente de lru).
+*/
+void CacheRangos::tocar(map<int, Tramo>::iterator it) {
+    lru.splice(lru.begin(), lru, it->second.en_lru);
+}
+
+/*
+sacar :: iterator -> iterator
+Descarta el tramo (de tramos y de lru) y devuelve el siguiente tramo.
+*/
+map<int, CacheRangos::Tramo>::iterator CacheRangos::sacar(map<int, Tramo>::iterator it) {
+    pares_guardados -= it->second.pares.size();
+    lru.erase(it->second.en_lru);
+    return tramos.erase(it);
+}
+
+/*
+guardar :: Int, Int, vector<pair<Int,Float>> -> Void
+Guarda pares como el contenido completo de [l, u] y lo junta con los tramos que lo solapan o estan pegados a el.
+Del tramo que empieza antes de l se conservan los pares con llave < l y del que termina despues de u los de llave > u.
+Despues descarta los tramos menos usados hasta volver a la capacidad; si el tramo nuevo no cabe solo, no se guarda.
+*/
+void CacheRangos::guardar(int l, int u, vector<pair<int,float>> pares) {
+    if (l > u) return;
+    auto it = primer_solapado(tramos, (long long)l - 1);
+    int inicio = l, fin = u;
+    vector<pair<int,float>> izquierda, derecha;
+    while (it != tramos.end() && (long long)it->first <= (long long)u + 1) {
+        const Tramo &t = it->second;
+        if (it->first < l) {
+            inicio = it->first;
+            for (auto &p : t.pares) if (p.first < l) izquierda.push_back(p);
+        }
+        if (t.u > u) {
+            fin = t.u;
+            for (auto &p : t.pares) if (p.first > u) derecha.push_back(p);
+        }
+        it = sacar(it);
+    }
+    izquierda.insert(izquierda.end(), pares.begin(), pares.end());
+    izquierda.insert(izquierda.end(), derecha.begin(), derecha.end());
+    if (izquierda.size() > capacidad_pares) return;
+
+    pares_guardados += izquierda.size();
+    lru.push_front(inicio);
+    tramos.emplace(inicio, Tramo{fin, move(izquierda), lru.begin()});
+
+    // El tramo nuevo esta al frente de lru y cabe solo, asi que nunca es el ultimo mientras se pase de la capacidad
+    while (pares_guardados > capacidad_pares) sacar(tramos.find(lru.back()));
+}
+
+/*
+invalidar :: Int, Int -> Void
+Saca [l, u] de la cache: los tramos que lo solapan se recortan y quedan solo las partes fuera de [l, u].
+*/
+void CacheRangos::invalidar(int l, int u) {
+    if (l > u) return;
+    auto it = primer_solapado(tramos, l);
+    vector<pair<int, Tramo>> restos;
+    while (it != tramos.end() && it->first <= u) {
+        Tramo &t = it->second;
+        // Los restos heredan la posicion del tramo en lru
+        if (it->first < l) {
+            Tramo izq{l - 1, {}, lru.insert(t.en_lru, it->first)};
+            for (auto &p : t.pares) if (p.first < l) izq.pares.push_back(p);
+            restos.emplace_back(it->first, move(izq));
+        }
+        if (t.u > u) {
+            Tramo der{t.u, {}, lru.insert(t.en_lru, u + 1)};
+            for (auto &p : t.pares) if (p.first > u) der.pares.push_back(p);
+            restos.emplace_back(u + 1, move(der));
+        }
+        it = sacar(it);
+    }
+    for (auto &r : restos) {
+        pares_guardados += r.second.pares.size();
+        tramos.emplace(r.first, move(r.second));
+    }
+}
+
+/*
+vaciar :: -> Void
+Descarta todos los tramos (por ejemplo despues de reconstruir el arbol).
+*/
+void CacheRangos::vaciar() {
+    tramos.clear();
+    lru.clear();
+    pares_guardados = 0;
+}
+
+/*
+range_search_Bplus_disk :: DiskManager, Int, CacheRangos, Int, Int, Int& -> vector<pair<Int,Float>>
+Busqueda de rango con el mismo resultado que range_search_Bplus_disk, pero pasando por la cache.
+Recorre [l, u] en orden: las partes cubiertas por un tramo se copian filtrando por llave y cada hueco se busca
+en el arbol (solo esas lecturas suman a io_busquedas). Al final guarda el resultado como tramo de [l, u].
+Lanza runtime_error si el archivo no mantiene la cadena de hojas (ver Superbloque::hojas_enlazadas).
+*/
+vector<pair<int,float>> range_search_Bplus_disk(DiskManager &dm, int root_idx, CacheRangos &cache,
+                                                int l, int u, int &io_busquedas) {
+    dm.exigir_hojas_enlazadas();
+    vector<pair<int,float>> out;
+    if (l > u) return out;
+    cache.consultas++;
+    bool leyo_arbol = false;
+    auto buscar_hueco = [&](long long a, long long b) {
+        auto hueco = range_search_Bplus_disk(dm, root_idx, (int)a, (int)b, io_busquedas);
+        out.insert(out.end(), hueco.begin(), hueco.end());
+        leyo_arbol = true;
+    };
+
+    long long cursor = l;
+    for (auto it = primer_solapado(cache.tramos, l); it != cache.tramos.end() && it->first <= u; ++it) {
+        CacheRangos::Tramo &t = it->second;
+        if (it->first > cursor) buscar_hueco(cursor, (long long)it->first - 1);
+        auto desde = lower_bound(t.pares.begin(), t.pares.end(), l,
+                                 [](const pair<int,float> &p, int x) { return p.first < x; });
+        for (; desde != t.pares.end() && desde->first <= u; ++desde) out.push_back(*desde);
+        cache.tocar(it);
+        cursor = (long long)t.u + 1;
+    }
+    if (cursor <= u) buscar_hueco(cursor, u);
+
+    if (leyo_arbol) cache.guardar(l, u, out);
+    else cache.consultas_completas++;
+    return out;
+}
@@ -0,0 +1,49 @@
+#ifndef CACHERANGO_H
+#define CACHERANGO_H
+
+#include "manejodisco.h"
+
+/*
+Pares que guarda la cache de rangos como maximo (8 bytes por par).
+*/
+constexpr size_t Capacidad_cache_por_defecto = 1 << 20;
+
+/*
+CacheRangos :: struct
+Cache semantica de resultados de busquedas de rango de un arbol B+.
+Guarda tramos [l, u] disjuntos y ordenados, cada uno con todos los pares del arbol cuya llave cae en el tramo
+(en el mismo orden en que los devuelve range_search_Bplus_disk). Una consulta se responde filtrando los tramos que
+la cubren y solo baja al arbol por los huecos; el resultado se guarda como tramo y se junta con los vecinos,
+asi que una ventana que se desliza solo lee la parte nueva.
+Se mantiene desde la insercion y el borrado (ver OpcionesArbol): tocar una llave saca esa llave de los tramos
+que la cubren, y el resto del tramo sigue siendo valido.
+Al pasar capacidad_pares se descartan los tramos usados hace mas tiempo: lru tiene los inicios de los tramos del mas
+al menos reciente y cada tramo guarda su posicion en esa lista, asi que usar un tramo o elegir cual descartar es O(1).
+*/
+struct CacheRangos {
+    struct Tramo {
+        int u;
+        std::vector<std::pair<int,float>> pares;
+        std::list<int>::iterator en_lru;
+    };
+
+    std::map<int, Tramo> tramos;   // inicio del tramo -> tramo
+    std::list<int> lru;            // inicios de los tramos, el usado mas recientemente primero
+    size_t capacidad_pares;
+    size_t pares_guardados = 0;
+    size_t consultas = 0;
+    size_t consultas_completas = 0; // consultas respondidas sin leer el arbol
+
+    explicit CacheRangos(size_t capacidad_pares = Capacidad_cache_por_defecto) : capacidad_pares(capacidad_pares) {}
+
+    void tocar(std::map<int, Tramo>::iterator it);
+    std::map<int, Tramo>::iterator sacar(std::map<int, Tramo>::iterator it);
+    void guardar(int l, int u, std::vector<std::pair<int,float>> pares);
+    void invalidar(int l, int u);
+    void vaciar();
+};
+
+std::vector<std::pair<int,float>> range_search_Bplus_disk(DiskManager &dm, int root_idx, CacheRangos &cache,
+                                                          int l, int u, int &io_busquedas);
+
+#endif
@@ -0,0 +1,88 @@
+#include <bits/stdc++.h>
+#include "driver.h"
+#include "busqueda.h"
+#include "almacen.h"
+using namespace std;
+
+const int MIN_KEY = 1546300800;
+const int MAX_KEY = 1754006400;
+const int RANGE_SIZE = 604800;
+const int Q = 50;
+const int MIN_EXP = 15;
+const int MAX_EXP = 20;
+
+/*
+medir :: Almacen, String, vector<pair<Int,Float>>, ofstream -> Void
+Construye un arbol B+ con los datos en el almacen, corre Q consultas de rango sobre el mismo almacen y escribe una
+fila con las lecturas y escrituras que conto el almacen y los tiempos de construccion y de consulta.
+Los almacenes con archivo fijan la raiz al terminar de construir (el de cache baja ahi sus paginas sucias), y eso
+cuenta en la construccion. IOs_busqueda son las lecturas que cuenta el almacen durante las consultas, no los nodos
+visitados: en el de cache solo suman los fallos.
+Las consultas usan siempre la misma semilla, asi que todos los almacenes responden las mismas ventanas.
+*/
+template <class Almacen>
+static void medir(Almacen &almacen, const string &tipo, const vector<pair<int,float>> &datos, ofstream &out) {
+    auto t1 = chrono::high_resolution_clock::now();
+    int raiz = construir_arbol(almacen, datos, true);
+    if constexpr (!is_same<Almacen, ListaNodo>::value) almacen.fijar_raiz(raiz, true);
+    auto t2 = chrono::high_resolution_clock::now();
+    double tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+    uint64_t ios_insert = almacen.reads + almacen.writes;
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> distL(MIN_KEY, MAX_KEY - RANGE_SIZE);
+    double sum_time = 0.0;
+    size_t sum_ios = 0, resultados = 0;
+    for (int q = 0; q < Q; q++) {
+        int l = distL(rng);
+        int u = l + RANGE_SIZE;
+        int io_busquedas = 0;
+        uint64_t lecturas = almacen.reads;
+        auto tq1 = chrono::high_resolution_clock::now();
+        auto res = range_search_Bplus(almacen, raiz, l, u, io_busquedas);
+        auto tq2 = chrono::high_resolution_clock::now();
+        sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+        sum_ios += almacen.reads - lecturas;
+        resultados += res.size();
+    }
+
+    cout << "[" << tipo << "] N=" << datos.size() << " construccion: " << tiempo_insert_ms << " ms, "
+         << ios_insert << " IOs, " << resultados << " resultados en " << Q << " consultas\n";
+    out << tipo << "," << datos.size() << "," << ios_insert << "," << almacen.size() << "," << sum_time / Q
+        << "," << double(sum_ios) / Q << "," << tiempo_insert_ms << "\n";
+}
+
+/*
+Compara los almacenes de nodos (ver almacen.h) corriendo la misma insercion y la misma busqueda de un arbol B+,
+instanciadas para cada uno. IOs_insert son las lecturas y escrituras que cuenta cada almacen: accesos a paginas en
+memoria y en mmap, transferencias con el archivo en el almacen de archivo y en el de cache (solo los fallos).
+*/
+int main() {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    ofstream out("almacenes.csv");
+    out << "almacen,N,IOs_insert,nodos,tiempo_busqueda_ms,IOs_busqueda,tiempo_insert_ms\n";
+
+    for (int exp = MIN_EXP; exp <= MAX_EXP; exp++) {
+        vector<pair<int,float>> datos = leer_datos("datos.bin", 1ULL << exp);
+        cout << "Comparando almacenes con N=" << datos.size() << "\n";
+
+        ListaNodo memoria;
+        medir(memoria, "memoria", datos, out);
+        {
+            AlmacenArchivo archivo("almacen_archivo_" + to_string(exp) + ".bin");
+            medir(archivo, "archivo", datos, out);
+        }
+        {
+            AlmacenCache cache("almacen_cache_" + to_string(exp) + ".bin");
+            medir(cache, "cache", datos, out);
+            cout << "[cache] " << cache.aciertos << " aciertos de " << cache.aciertos + cache.reads << " lecturas\n";
+        }
+        {
+            AlmacenMmap mapeado("almacen_mmap_" + to_string(exp) + ".bin");
+            medir(mapeado, "mmap", datos, out);
+        }
+    }
+    return 0;
+}
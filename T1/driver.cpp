@@ -1,15 +1,17 @@
 #include "driver.h"
 #include "btree.h"
+#include "almacen.h"
 #include <fstream>
 using namespace std;
 
 /*
-leer_datos :: String, Int -> vector<pair<Int,Float>>
-Lee N pares llave-valor desde el archivo fname y los devuelve en un vector.
+leer_datos :: String, Int, Int -> vector<pair<Int,Float>>
+Lee N pares llave-valor desde el archivo fname, empezando en el par numero desde, y los devuelve en un vector.
 Cada par llave-valor en el archivo está almacenado en binario, con la llave como un int (4 bytes) y el valor como un float (4 bytes).
 */
-vector<pair<int,float>> leer_datos(const string &fname, size_t N) {
+vector<pair<int,float>> leer_datos(const string &fname, size_t N, size_t desde) {
     ifstream ifs(fname, ios::binary);
+    ifs.seekg((std::streamoff)desde * (sizeof(int) + sizeof(float)), ios::beg);
     vector<pair<int,float>> datos;
     datos.reserve(N);
     for (size_t i = 0; i < N; i++) {
@@ -23,13 +25,37 @@ vector<pair<int,float>> leer_datos(const string &fname, size_t N) {
 }
 
 /*
-construir_arbol :: ListaNodo, vector<pair<Int,Float>>, Bool -> Int
-Construye un arbol B o B+ (segun is_Bplus) insertando los pares llave-valor.
-Devuelve el índice de la raíz del árbol.
+construir_arbol :: Almacen, vector<pair<Int,Float>>, Bool, OpcionesArbol -> Int
+Construye un arbol B o B+ (segun is_Bplus) en el almacen (ver almacen.h) insertando los pares llave-valor con las opciones dadas.
+Devuelve el índice de la raíz del árbol. Con copy-on-write la raiz queda registrada en la epoca actual.
 */
-int construir_arbol(ListaNodo &arr, const vector<pair<int,float>> &datos, bool is_Bplus) {
+template <class Almacen>
+int construir_arbol(Almacen &arr, const vector<pair<int,float>> &datos, bool is_Bplus, const OpcionesArbol &opciones) {
     Nodo root;
-    int root_idx = arr.append(root);
-    for (auto &p : datos) insert(arr, root_idx, p.first, p.second, is_Bplus);
+    int root_idx = append_node(arr, opciones, root);
+    extender_arbol(arr, root_idx, datos, 0, is_Bplus, opciones);
     return root_idx;
 }
+
+/*
+extender_arbol :: Almacen, Int&, vector<pair<Int,Float>>, Int, Bool, OpcionesArbol -> Void
+Inserta en un arbol ya construido los pares de datos desde la posicion desde en adelante.
+Hacer crecer un arbol por tramos deja el mismo arbol (y cuenta las mismas lecturas y escrituras) que construirlo de una vez.
+*/
+template <class Almacen>
+void extender_arbol(Almacen &arr, int &root_idx, const vector<pair<int,float>> &datos, size_t desde, bool is_Bplus,
+                    const OpcionesArbol &opciones) {
+    for (size_t i = desde; i < datos.size(); i++) insert(arr, root_idx, datos[i].first, datos[i].second, is_Bplus, opciones);
+}
+
+/*
+Instancias de la construccion para cada almacen (ver almacen.h).
+*/
+#define INSTANCIAR_CONSTRUCCION(Almacen) \
+    template int construir_arbol<Almacen>(Almacen &, const vector<pair<int,float>> &, bool, const OpcionesArbol &); \
+    template void extender_arbol<Almacen>(Almacen &, int &, const vector<pair<int,float>> &, size_t, bool, const OpcionesArbol &);
+
+INSTANCIAR_CONSTRUCCION(ListaNodo)
+INSTANCIAR_CONSTRUCCION(AlmacenArchivo)
+INSTANCIAR_CONSTRUCCION(AlmacenCache)
+INSTANCIAR_CONSTRUCCION(AlmacenMmap)
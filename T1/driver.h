@@ -2,8 +2,14 @@
 #define DRIVER_H
 
 #include "listanodo.h"
+#include "btree.h"
 
-std::vector<std::pair<int,float>> leer_datos(const std::string &fname, size_t N);
-int construir_arbol(ListaNodo &arr, const std::vector<std::pair<int,float>> &datos, bool is_Bplus);
+std::vector<std::pair<int,float>> leer_datos(const std::string &fname, size_t N, size_t desde = 0);
+template <class Almacen>
+int construir_arbol(Almacen &arr, const std::vector<std::pair<int,float>> &datos, bool is_Bplus,
+                    const OpcionesArbol &options = OpcionesArbol());
+template <class Almacen>
+void extender_arbol(Almacen &arr, int &root_idx, const std::vector<std::pair<int,float>> &datos, size_t desde, bool is_Bplus,
+                    const OpcionesArbol &options = OpcionesArbol());
 
 #endif
@@ -0,0 +1,90 @@
+#include "eytzinger.h"
+using namespace std;
+
+/*
+collect_leaves :: ListaNodo, Int, vector<Int>&, vector<Int>& -> Void
+Recorre en orden los niveles internos (ya en memoria, sin contar lecturas) y junta las hojas y los separadores entre ellas.
+El separador i es el par del ancestro que divide la hoja i de la hoja i+1.
+*/
+static void collect_leaves(const ListaNodo &arr, int idx, vector<int> &hojas, vector<int> &separadores) {
+    const Nodo &nodo = arr.nodes[idx];
+    if (!nodo.es_interno) {
+        hojas.push_back(idx);
+        return;
+    }
+    for (int i = 0; i <= nodo.k; ++i) {
+        collect_leaves(arr, nodo.hijos[i], hojas, separadores);
+        if (i < nodo.k) separadores.push_back(nodo.pares[i].llave);
+    }
+}
+
+/*
+fill_eytzinger :: vector<Int>, vector<Int>, IndiceEytzinger&, Size&, Size -> Void
+Copia el arreglo ordenado a orden de Eytzinger con un recorrido en orden del arbol implicito (hijos de k en 2k y 2k+1).
+*/
+static void fill_eytzinger(const vector<int> &ordenados, const vector<int> &hojas, IndiceEytzinger &indice, size_t &i, size_t k) {
+    if (k >= indice.separadores.size()) return;
+    fill_eytzinger(ordenados, hojas, indice, i, 2 * k);
+    indice.separadores[k] = ordenados[i];
+    indice.hojas[k] = hojas[i];
+    i++;
+    fill_eytzinger(ordenados, hojas, indice, i, 2 * k + 1);
+}
+
+/*
+construir_eytzinger :: ListaNodo, Int -> IndiceEytzinger
+Construye el indice a partir de un arbol B+ en memoria.
+*/
+IndiceEytzinger construir_eytzinger(const ListaNodo &arr, int indice_raiz) {
+    vector<int> hojas, separadores;
+    collect_leaves(arr, indice_raiz, hojas, separadores);
+    IndiceEytzinger indice;
+    indice.separadores.assign(separadores.size() + 1, 0);
+    indice.hojas.assign(separadores.size() + 1, hojas.back());
+    size_t i = 0;
+    fill_eytzinger(separadores, hojas, indice, i, 1);
+    return indice;
+}
+
+/*
+buscar_hoja :: Int -> Int
+Devuelve la hoja donde empiezan las llaves >= llave: la del primer separador >= llave, o la ultima hoja si no hay.
+Es la misma hoja a la que llega find_child_index bajando por el arbol.
+*/
+int IndiceEytzinger::buscar_hoja(int llave) const {
+    size_t n = separadores.size();
+    size_t k = 1;
+    while (k < n) {
+#if defined(__GNUC__)
+        // 16 enteros = una linea de 64 bytes: los descendientes de k cuatro niveles mas abajo son contiguos
+        __builtin_prefetch(separadores.data() + min(k * 16, n - 1));
+#endif
+        k = 2 * k + (separadores[k] < llave);
+    }
+    // Se deshacen los pasos a la derecha del final: k queda en el ultimo nodo donde se fue a la izquierda
+    k >>= __builtin_ffsll(~(unsigned long long)k);
+    return hojas[k];
+}
+
+/*
+range_search_Bplus_eytzinger :: DiskManager, IndiceEytzinger, Int, Int, Int& -> vector<pair<Int,Float>>
+Busqueda de rango de un B+ que encuentra la hoja inicial en memoria y luego recorre la cadena de hojas en disco.
+Lanza runtime_error si el archivo no mantiene la cadena de hojas (ver Superbloque::hojas_enlazadas).
+*/
+vector<pair<int,float>> range_search_Bplus_eytzinger(DiskManager &dm, const IndiceEytzinger &indice, int l, int u, int &io_busquedas) {
+    dm.exigir_hojas_enlazadas();
+    vector<pair<int,float>> out;
+    if (l > u) return out;
+    int indice_iterador = indice.buscar_hoja(l);
+    while (indice_iterador != -1) {
+        io_busquedas++;
+        Nodo hoja = dm.read_node_at(indice_iterador);
+        for (int i = 0; i < hoja.k; ++i) {
+            if (hoja.pares[i].llave > u) return out;
+            if (hoja.pares[i].llave >= l && !es_lapida(hoja.pares[i]))
+                out.emplace_back(hoja.pares[i].llave, hoja.pares[i].valor);
+        }
+        indice_iterador = hoja.siguiente;
+    }
+    return out;
+}
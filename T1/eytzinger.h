@@ -0,0 +1,23 @@
+#ifndef EYTZINGER_H
+#define EYTZINGER_H
+
+#include "manejodisco.h"
+
+/*
+IndiceEytzinger :: struct
+Reemplazo en memoria de los niveles internos de un arbol B+: los separadores entre hojas consecutivas guardados en
+orden de Eytzinger (el arbol binario completo en orden BFS, con la raiz en la posicion 1). La busqueda baja sin saltos
+condicionales y precarga la linea de cache de cuatro niveles mas abajo, en vez de recorrer arreglos de 340 llaves por nivel.
+Las hojas siguen siendo paginas de 4 KB en disco. Es una foto del arbol: hay que reconstruirlo despues de insertar.
+*/
+struct IndiceEytzinger {
+    std::vector<int> separadores;   // separadores[1..m-1] en orden de Eytzinger, separadores[0] sin uso
+    std::vector<int> hojas;         // hojas[k] = hoja a la que lleva el separador en la posicion k; hojas[0] = ultima hoja
+
+    int buscar_hoja(int llave) const;
+};
+
+IndiceEytzinger construir_eytzinger(const ListaNodo &arr, int root_idx);
+std::vector<std::pair<int,float>> range_search_Bplus_eytzinger(DiskManager &dm, const IndiceEytzinger &indice, int l, int u, int &io_busquedas);
+
+#endif
@@ -0,0 +1,168 @@
+#include "indicehash.h"
+#include "btree.h"
+using namespace std;
+
+/*
+hash_llave :: Int -> UInt64
+Mezcla la llave (los timestamps son casi consecutivos y no sirven directamente como hash).
+*/
+static uint64_t hash_llave(int llave) {
+    uint64_t x = (uint32_t)llave;
+    x = (x ^ (x >> 16)) * 0x45D9F3B;
+    x = (x ^ (x >> 16)) * 0x45D9F3B;
+    return x ^ (x >> 16);
+}
+
+/*
+asignar :: Int, Int, Int -> Void
+Agrega la llave o actualiza su ubicacion si ya estaba.
+*/
+void IndiceHash::asignar(int llave, int hoja, int ranura) {
+    if (baldes.empty() || cantidad + 1 > Carga_maxima_hash * baldes.size() * Entradas_por_balde) {
+        // Se rehace con el doble de baldes
+        vector<BaldeHash> viejos(max<size_t>(1, baldes.size() * 2));
+        viejos.swap(baldes);
+        cantidad = 0;
+        for (auto &balde : viejos)
+            for (int i = 0; i < balde.cantidad; ++i)
+                asignar(balde.entradas[i].llave, balde.entradas[i].hoja, balde.entradas[i].ranura);
+    }
+    size_t b = hash_llave(llave) % baldes.size();
+    while (true) {
+        BaldeHash &balde = baldes[b];
+        for (int i = 0; i < balde.cantidad; ++i) {
+            if (balde.entradas[i].llave == llave) {
+                balde.entradas[i].hoja = hoja;
+                balde.entradas[i].ranura = ranura;
+                return;
+            }
+        }
+        if (balde.cantidad < Entradas_por_balde) {
+            balde.entradas[balde.cantidad++] = {llave, hoja, ranura};
+            cantidad++;
+            return;
+        }
+        b = (b + 1) % baldes.size();
+    }
+}
+
+/*
+buscar :: Int -> EntradaHash*
+Devuelve la entrada de la llave o nullptr si no esta.
+*/
+const EntradaHash *IndiceHash::buscar(int llave) const {
+    if (baldes.empty()) return nullptr;
+    size_t b = hash_llave(llave) % baldes.size();
+    for (size_t vistos = 0; vistos < baldes.size(); ++vistos) {
+        const BaldeHash &balde = baldes[b];
+        for (int i = 0; i < balde.cantidad; ++i)
+            if (balde.entradas[i].llave == llave) return &balde.entradas[i];
+        if (balde.cantidad < Entradas_por_balde) return nullptr;
+        b = (b + 1) % baldes.size();
+    }
+    return nullptr;
+}
+
+/*
+indexar_hoja :: Int, Nodo -> Void
+Apunta a la hoja idx todas las llaves que contiene. Se usa cuando los pares de una hoja cambian de pagina
+(division, reparto entre hermanos, mezcla).
+*/
+void IndiceHash::indexar_hoja(int idx, const Nodo &hoja) {
+    for (int i = 0; i < hoja.k; ++i)
+        if (i == 0 || hoja.pares[i].llave != hoja.pares[i-1].llave) asignar(hoja.pares[i].llave, idx, i);
+}
+
+/*
+remapear :: vector<Int> -> Void
+Cambia cada hoja h por nueva_posicion[h] (cuando los nodos del arbol se reubican). Las entradas que apuntan a
+paginas que ya no son del arbol quedan en -1 y get busca esas llaves bajando por el arbol.
+*/
+void IndiceHash::remapear(const vector<int> &nueva_posicion) {
+    for (auto &balde : baldes)
+        for (int i = 0; i < balde.cantidad; ++i) {
+            int &hoja = balde.entradas[i].hoja;
+            hoja = (hoja >= 0 && hoja < (int)nueva_posicion.size()) ? nueva_posicion[hoja] : -1;
+        }
+}
+
+/*
+buscar_en_hoja :: Nodo, EntradaHash, Int, Float& -> Bool
+Busca la llave en la hoja, primero en la ranura de la pista y si no, por busqueda binaria. Se salta las lapidas.
+*/
+static bool buscar_en_hoja(const Nodo &hoja, const EntradaHash &entrada, int llave, float &valor) {
+    // La pagina pudo liberarse en una compactacion y reutilizarse como nodo interno
+    if (hoja.es_interno) return false;
+    int i = entrada.ranura;
+    if (i >= hoja.k || hoja.pares[i].llave != llave) {
+        int lo = 0, hi = hoja.k;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (hoja.pares[mid].llave < llave) lo = mid + 1;
+            else hi = mid;
+        }
+        i = lo;
+    }
+    while (i > 0 && hoja.pares[i-1].llave == llave) i--;
+    for (; i < hoja.k && hoja.pares[i].llave == llave; ++i) {
+        if (!es_lapida(hoja.pares[i])) {
+            valor = hoja.pares[i].valor;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+buscar_en_arbol :: Almacen, Int, Int, Float&, Int& -> Bool
+Baja por todos los hijos que pueden tener la llave (con llaves repetidas pueden ser varios) y devuelve el primer valor
+vivo que encuentre en las hojas. Es el respaldo de get cuando la hoja del indice no tiene la llave viva.
+*/
+template <class Almacen>
+static bool buscar_en_arbol(Almacen &almacen, int idx, int llave, float &valor, int &io_busquedas) {
+    if (idx == -1) return false;
+    io_busquedas++;
+    Nodo node = almacen.read(idx);
+    if (!node.es_interno) {
+        for (int i = 0; i < node.k; ++i) {
+            if (node.pares[i].llave == llave && !es_lapida(node.pares[i])) {
+                valor = node.pares[i].valor;
+                return true;
+            }
+        }
+        return false;
+    }
+    for (int i = 0; i <= node.k; ++i)
+        if (node.hijos[i] != -1 && hijo_solapa(node, i, llave, llave)
+            && buscar_en_arbol(almacen, node.hijos[i], llave, valor, io_busquedas)) return true;
+    return false;
+}
+
+/*
+get :: ListaNodo, IndiceHash, Int, Int, Float& -> Bool
+Busca una llave exacta leyendo solo la hoja que indica el indice hash (una lectura, sin bajar por el arbol).
+Si esa hoja no tiene la llave viva, la busca bajando por el arbol desde la raiz: con llaves repetidas el indice guarda
+una sola de las hojas donde aparecen.
+Si la llave esta repetida devuelve el valor de alguna de sus apariciones. Devuelve false si no esta o fue borrada.
+*/
+bool get(ListaNodo &arr, const IndiceHash &indice, int raiz, int llave, float &valor) {
+    const EntradaHash *entrada = indice.buscar(llave);
+    if (entrada == nullptr) return false;
+    if (entrada->hoja != -1 && buscar_en_hoja(arr.read(entrada->hoja), *entrada, llave, valor)) return true;
+    int io_busquedas = 0;
+    return buscar_en_arbol(arr, raiz, llave, valor, io_busquedas);
+}
+
+/*
+get_disk :: DiskManager, IndiceHash, Int, Int, Float&, Int& -> Bool
+Igual que get, sobre el arbol escrito en disco: una lectura de pagina por busqueda, mas las del arbol si hay que bajar.
+*/
+bool get_disk(DiskManager &dm, const IndiceHash &indice, int raiz, int llave, float &valor, int &io_busquedas) {
+    const EntradaHash *entrada = indice.buscar(llave);
+    if (entrada == nullptr) return false;
+    if (entrada->hoja != -1) {
+        io_busquedas++;
+        if (buscar_en_hoja(dm.read_node_at(entrada->hoja), *entrada, llave, valor)) return true;
+    }
+    return buscar_en_arbol(dm, raiz, llave, valor, io_busquedas);
+}
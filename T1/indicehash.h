@@ -0,0 +1,53 @@
+#ifndef INDICEHASH_H
+#define INDICEHASH_H
+
+#include "manejodisco.h"
+
+/*
+EntradaHash :: struct
+Ubicacion de una llave en un arbol B+: la hoja donde esta y la posicion donde estaba al indexarla (pista; las
+inserciones posteriores en la hoja la pueden correr, y en ese caso se busca la llave dentro de la hoja).
+*/
+struct EntradaHash {
+    int llave;
+    int hoja;
+    int ranura;
+};
+
+constexpr int Entradas_por_balde = (Bytes_nodo - (int)sizeof(int)) / (int)sizeof(EntradaHash);
+
+/*
+BaldeHash :: struct
+Balde de una pagina (4 KB) con hasta Entradas_por_balde entradas.
+*/
+struct BaldeHash {
+    int cantidad = 0;
+    EntradaHash entradas[Entradas_por_balde];
+};
+static_assert(sizeof(BaldeHash) <= Bytes_nodo, "Un balde debe caber en una pagina");
+
+constexpr double Carga_maxima_hash = 0.75;
+
+/*
+IndiceHash :: struct
+Indice de llaves exactas de un arbol B+ con sondeo lineal por baldes: la llave va al balde hash % baldes.size() y,
+si esta lleno, al siguiente. Una busqueda se detiene en el primer balde que no esta lleno.
+Se mantiene desde la insercion (ver OpcionesArbol) y crece al doble al pasar Carga_maxima_hash.
+Con llaves repetidas guarda una sola hoja por llave, la ultima que se indexo; las apariciones pueden repartirse en varias
+hojas (por ejemplo, al dividirse una hoja), asi que si esa hoja no tiene la llave viva, get baja por el arbol desde la raiz.
+*/
+struct IndiceHash {
+    std::vector<BaldeHash> baldes;
+    size_t cantidad = 0;
+
+    void asignar(int llave, int hoja, int ranura);
+    const EntradaHash *buscar(int llave) const;
+    void indexar_hoja(int idx, const Nodo &hoja);
+    void remapear(const std::vector<int> &nueva_posicion);
+    size_t tam_bytes() const { return baldes.size() * sizeof(BaldeHash); }
+};
+
+bool get(ListaNodo &arr, const IndiceHash &indice, int raiz, int llave, float &valor);
+bool get_disk(DiskManager &dm, const IndiceHash &indice, int raiz, int llave, float &valor, int &io_busquedas);
+
+#endif
@@ -2,14 +2,19 @@
 #define NODEARRAY_H
 
 #include "nodo.h"
+#include "arena.h"
 
 /*
 ListaNodo :: struct
 Estructura que representa una lista de nodos en memoria.
-Contiene un vector de nodos y contadores de lecturas y escrituras.
+Contiene un arena de nodos (direcciones estables, agregar no copia el arbol), contadores de lecturas y escrituras,
+y una lista de posiciones libres (nodos liberados por la compactacion) que append reutiliza antes de crecer el arena.
+Es el almacen en memoria de la insercion y la busqueda en plantilla (ver almacen.h); size, read y write se definen
+aqui abajo para que esas plantillas los expandan en linea.
 */
 struct ListaNodo {
-    std::vector<Nodo> nodes;
+    ArenaNodos nodes;
+    std::vector<int> libres;
     uint64_t reads = 0;
     uint64_t writes = 0;
 
@@ -17,6 +22,37 @@ struct ListaNodo {
     Nodo read(int idx);
     void write(int idx, const Nodo &n);
     int append(const Nodo &n);
+    void liberar(int idx);
 };
 
+inline int ListaNodo::size() const { return (int)nodes.size(); }
+
+/*
+read :: Int -> Nodo
+Lee el nodo en la posición idx de la lista de nodos.
+aumenta el contador de lecturas.
+*/
+inline Nodo ListaNodo::read(int idx) {
+    if (idx < 0 || idx >= (int)nodes.size()) {
+        std::cerr << "ERROR: intento de leer nodo inválido idx=" << idx
+             << " size=" << nodes.size() << "\n";
+        throw std::runtime_error("Índice inválido en ListaNodo::read");
+    }
+    reads++;
+    return nodes[idx];
+}
+
+/*
+write :: Int, Nodo -> Void
+Escribe el nodo n en la posición idx de la lista de nodos.
+aumenta el contador de escrituras.
+*/
+inline void ListaNodo::write(int idx, const Nodo &n) {
+    if (idx >= size()) {
+        nodes.resize(idx + 1);
+    }
+    nodes[idx] = n;
+    writes++;
+}
+
 #endif
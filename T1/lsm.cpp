@@ -0,0 +1,213 @@
+#include "lsm.h"
+#include <cstdio>
+using namespace std;
+
+/*
+mezclar_hash :: UInt64 -> UInt64
+Mezclador de splitmix64, para derivar los hashes del filtro de Bloom a partir de la llave.
+*/
+static uint64_t mezclar_hash(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/*
+iniciar :: Size -> Void
+Reserva Bits_por_llave_bloom bits por llave.
+*/
+void FiltroBloom::iniciar(size_t llaves) {
+    size_t cantidad_bits = max<size_t>(64, llaves * Bits_por_llave_bloom);
+    bits.assign((cantidad_bits + 63) / 64, 0);
+}
+
+/*
+agregar :: Int -> Void
+Marca los Hashes_bloom bits de la llave (doble hashing: h1 + i * h2).
+*/
+void FiltroBloom::agregar(int llave) {
+    uint64_t h = mezclar_hash((uint32_t)llave);
+    uint64_t h1 = h & 0xFFFFFFFF, h2 = (h >> 32) | 1;
+    uint64_t total = bits.size() * 64;
+    for (int i = 0; i < Hashes_bloom; ++i) {
+        uint64_t b = (h1 + i * h2) % total;
+        bits[b >> 6] |= 1ULL << (b & 63);
+    }
+}
+
+/*
+puede_contener :: Int -> Bool
+False si la llave seguro no esta en la corrida.
+*/
+bool FiltroBloom::puede_contener(int llave) const {
+    uint64_t h = mezclar_hash((uint32_t)llave);
+    uint64_t h1 = h & 0xFFFFFFFF, h2 = (h >> 32) | 1;
+    uint64_t total = bits.size() * 64;
+    for (int i = 0; i < Hashes_bloom; ++i) {
+        uint64_t b = (h1 + i * h2) % total;
+        if (!(bits[b >> 6] & (1ULL << (b & 63)))) return false;
+    }
+    return true;
+}
+
+ArbolLSM::ArbolLSM(string prefijo_): prefijo(move(prefijo_)) {}
+
+/*
+~ArbolLSM :: -> Void
+Borra los archivos de las corridas vivas.
+*/
+ArbolLSM::~ArbolLSM() {
+    for (auto &corrida : niveles)
+        if (corrida.n > 0) remove(corrida.archivo.c_str());
+}
+
+/*
+capacidad_nivel :: Int -> Size
+Cantidad maxima de pares del nivel dado.
+*/
+static size_t capacidad_nivel(int nivel) {
+    size_t capacidad = Capacidad_memtable;
+    for (int i = 0; i <= nivel; ++i) capacidad *= Factor_niveles;
+    return capacidad;
+}
+
+/*
+escribir_corrida :: vector<pair<Int,Float>>, String, UInt64& -> Corrida
+Escribe los pares (ya ordenados) como hojas de B pares en un archivo nuevo y arma las cercas y el filtro de Bloom.
+Suma a paginas_escritas solo las paginas de datos, sin el superbloque del archivo.
+*/
+static Corrida escribir_corrida(const vector<pair<int,float>> &pares, const string &archivo, uint64_t &paginas_escritas) {
+    Corrida corrida;
+    corrida.archivo = archivo;
+    corrida.n = (int)pares.size();
+    corrida.min_llave = pares.front().first;
+    corrida.max_llave = pares.back().first;
+    corrida.filtro.iniciar(pares.size());
+
+    ListaNodo paginas;
+    for (size_t i = 0; i < pares.size(); i += B) {
+        Nodo hoja;
+        for (size_t j = i; j < pares.size() && j < i + B; ++j) {
+            hoja.pares[hoja.k].llave = pares[j].first;
+            hoja.pares[hoja.k].valor = pares[j].second;
+            hoja.k++;
+            corrida.filtro.agregar(pares[j].first);
+        }
+        hoja.siguiente = (i + B < pares.size()) ? paginas.size() + 1 : -1;
+        corrida.cercas.push_back(hoja.pares[0].llave);
+        paginas.append(hoja);
+    }
+    DiskManager dm(archivo);
+    dm.write_all(paginas);
+    paginas_escritas += paginas.size();
+    return corrida;
+}
+
+/*
+leer_corrida :: Corrida, UInt64& -> vector<pair<Int,Float>>
+Lee de una pasada todas las paginas de una corrida (para mezclarla en una compactacion).
+Suma a paginas_leidas solo las paginas de datos, sin el superbloque del archivo.
+*/
+static vector<pair<int,float>> leer_corrida(const Corrida &corrida, uint64_t &paginas_leidas) {
+    vector<pair<int,float>> pares;
+    pares.reserve(corrida.n);
+    DiskManager dm = DiskManager::open(corrida.archivo);
+    ListaNodo paginas;
+    dm.cargar(paginas);
+    for (int p = 0; p < paginas.size(); ++p) {
+        const Nodo &hoja = paginas.nodes[p];
+        for (int i = 0; i < hoja.k; ++i) pares.emplace_back(hoja.pares[i].llave, hoja.pares[i].valor);
+    }
+    paginas_leidas += paginas.size();
+    return pares;
+}
+
+/*
+insert :: Int, Float -> Void
+Agrega el par a la memtable y la escribe a disco cuando llega a Capacidad_memtable pares.
+*/
+void ArbolLSM::insert(int llave, float valor) {
+    memtable.emplace(llave, valor);
+    pares_insertados++;
+    if ((int)memtable.size() >= Capacidad_memtable) flush();
+}
+
+/*
+flush :: -> Void
+Baja la memtable a disco. Empezando en el nivel 0, mezcla lo que se lleva con la corrida del nivel (la mas nueva va
+despues entre llaves iguales) y, si el resultado supera la capacidad del nivel, sigue al nivel siguiente.
+La mezcla se escribe una sola vez, en el nivel donde cabe; las corridas mezcladas se borran.
+*/
+void ArbolLSM::flush() {
+    if (memtable.empty()) return;
+    vector<pair<int,float>> llevando(memtable.begin(), memtable.end());
+    memtable.clear();
+
+    for (int nivel = 0;; ++nivel) {
+        if (nivel == (int)niveles.size()) niveles.emplace_back();
+        if (niveles[nivel].n > 0) {
+            Corrida vieja = move(niveles[nivel]);
+            niveles[nivel] = Corrida();
+            vector<pair<int,float>> antiguos = leer_corrida(vieja, paginas_leidas);
+            remove(vieja.archivo.c_str());
+            vector<pair<int,float>> mezcla;
+            mezcla.reserve(antiguos.size() + llevando.size());
+            merge(antiguos.begin(), antiguos.end(), llevando.begin(), llevando.end(), back_inserter(mezcla),
+                  [](const pair<int,float> &a, const pair<int,float> &b) { return a.first < b.first; });
+            llevando.swap(mezcla);
+        }
+        if (llevando.size() <= capacidad_nivel(nivel)) {
+            string archivo = prefijo + "_" + to_string(siguiente_corrida++) + ".bin";
+            niveles[nivel] = escribir_corrida(llevando, archivo, paginas_escritas);
+            return;
+        }
+    }
+}
+
+/*
+range_search :: Int, Int, Int& -> vector<pair<Int,Float>>
+Busca [l, u] en la memtable y en cada corrida cuyo rango de llaves lo solapa (si l == u, ademas en las que
+el filtro de Bloom no descarta). En cada corrida las cercas dan la primera pagina a leer: la ultima cuya primera
+llave es menor que l (puede terminar con llaves l repetidas). Devuelve los pares ordenados por llave.
+*/
+vector<pair<int,float>> ArbolLSM::range_search(int l, int u, int &io_busquedas) {
+    vector<pair<int,float>> out;
+    if (l > u) return out;
+    for (auto &corrida : niveles) {
+        if (corrida.n == 0 || corrida.max_llave < l || corrida.min_llave > u) continue;
+        if (l == u && !corrida.filtro.puede_contener(l)) continue;
+        DiskManager dm(corrida.archivo);
+        int pagina = (int)(lower_bound(corrida.cercas.begin(), corrida.cercas.end(), l) - corrida.cercas.begin());
+        if (pagina > 0) pagina--;
+        for (; pagina < (int)corrida.cercas.size() && corrida.cercas[pagina] <= u; ++pagina) {
+            io_busquedas++;
+            Nodo hoja = dm.read_node_at(pagina);
+            for (int i = 0; i < hoja.k; ++i)
+                if (hoja.pares[i].llave >= l && hoja.pares[i].llave <= u)
+                    out.emplace_back(hoja.pares[i].llave, hoja.pares[i].valor);
+        }
+    }
+    for (auto it = memtable.lower_bound(l); it != memtable.end() && it->first <= u; ++it) out.push_back(*it);
+    stable_sort(out.begin(), out.end(), [](const pair<int,float> &a, const pair<int,float> &b) { return a.first < b.first; });
+    return out;
+}
+
+/*
+amplificacion_escritura :: -> Double
+Paginas escritas en disco por cada pagina de datos insertada.
+*/
+double ArbolLSM::amplificacion_escritura() const {
+    double paginas_datos = double(pares_insertados) / B;
+    return paginas_datos > 0 ? paginas_escritas / paginas_datos : 0.0;
+}
+
+/*
+paginas :: -> Size
+Cantidad de paginas de datos de todas las corridas vivas.
+*/
+size_t ArbolLSM::paginas() const {
+    size_t total = 0;
+    for (auto &corrida : niveles) total += corrida.cercas.size();
+    return total;
+}
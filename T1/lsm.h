@@ -0,0 +1,71 @@
+#ifndef LSM_H
+#define LSM_H
+
+#include "manejodisco.h"
+
+/*
+Parametros del arbol LSM: pares que se juntan en memoria antes de escribir una corrida, razon de tamaño entre niveles
+consecutivos, y bits por llave y funciones de hash de los filtros de Bloom (10 bits y 7 hashes dan ~1% de falsos positivos).
+*/
+constexpr int Capacidad_memtable = 64 * B;
+constexpr int Factor_niveles = 4;
+constexpr int Bits_por_llave_bloom = 10;
+constexpr int Hashes_bloom = 7;
+
+/*
+FiltroBloom :: struct
+Filtro de Bloom sobre las llaves de una corrida. Puede dar falsos positivos pero nunca falsos negativos.
+*/
+struct FiltroBloom {
+    std::vector<uint64_t> bits;
+
+    void iniciar(size_t llaves);
+    void agregar(int llave);
+    bool puede_contener(int llave) const;
+};
+
+/*
+Corrida :: struct
+Secuencia inmutable de pares ordenados por llave, escrita en su propio archivo como hojas de B pares
+(paginas Nodo encadenadas por siguiente). En memoria quedan las cercas (la primera llave de cada pagina),
+el rango de llaves y el filtro de Bloom, para leer solo las paginas que pueden tener resultados.
+*/
+struct Corrida {
+    std::string archivo;
+    int n = 0;
+    int min_llave = 0;
+    int max_llave = 0;
+    std::vector<int> cercas;
+    FiltroBloom filtro;
+};
+
+/*
+ArbolLSM :: struct
+Arbol LSM con compactacion por niveles: las inserciones van a una memtable en memoria y, cuando se llena, se ordena y
+se mezcla hacia abajo. Cada nivel tiene a lo mas una corrida; el nivel i admite Capacidad_memtable * Factor_niveles^(i+1)
+pares y, si la mezcla no cabe, sigue bajando al nivel siguiente. Las llaves repetidas se conservan todas, como en los arboles.
+Cuenta las paginas de datos escritas y leidas en disco para medir la amplificacion de escritura.
+Es dueño de los archivos de sus corridas (los borra al destruirse), asi que no se puede copiar.
+*/
+struct ArbolLSM {
+    std::string prefijo;
+    std::multimap<int,float> memtable;
+    std::vector<Corrida> niveles;   // niveles[i].n == 0 si el nivel esta vacio
+    int siguiente_corrida = 0;
+    uint64_t pares_insertados = 0;
+    uint64_t paginas_escritas = 0;
+    uint64_t paginas_leidas = 0;
+
+    ArbolLSM(std::string prefijo);
+    ArbolLSM(const ArbolLSM &) = delete;
+    ArbolLSM &operator=(const ArbolLSM &) = delete;
+    ~ArbolLSM();
+
+    void insert(int llave, float valor);
+    void flush();
+    std::vector<std::pair<int,float>> range_search(int l, int u, int &io_busquedas);
+    double amplificacion_escritura() const;
+    size_t paginas() const;
+};
+
+#endif
@@ -2,43 +2,118 @@
 #include "driver.h"
 #include "manejodisco.h"
 #include "busqueda.h"
+#include "borrado.h"
+#include "aprendido.h"
+#include "eytzinger.h"
+#include "particiones.h"
+#include "lsm.h"
+#include "cacherango.h"
 using namespace std;
 
 const int MIN_KEY = 1546300800;
 const int MAX_KEY = 1754006400;
 const int RANGE_SIZE = 604800;
 const int Q = 50;
+const int PASO_VENTANA = 86400; // la ventana de la consulta con cache avanza un dia por consulta
 
-int main() {
+/*
+reabrir_arbol :: DiskManager, Bool -> Bool
+Intenta reabrir el archivo del arbol desde su superbloque. Devuelve false si no existe, no es valido
+o guarda otro tipo de arbol, en cuyo caso hay que construirlo.
+*/
+static bool reabrir_arbol(DiskManager &dm, bool es_Bplus) {
+    try {
+        DiskManager abierto = DiskManager::open(dm.filename);
+        if (abierto.cabecera.es_Bplus != (int)es_Bplus || abierto.cabecera.raiz < 0) return false;
+        dm = abierto;
+        return true;
+    } catch (const runtime_error &) {
+        return false;
+    }
+}
+
+/*
+retomar_arbol :: String, ListaNodo, Int& -> Void
+Carga a memoria un arbol reabierto para seguir haciendolo crecer. Sus contadores de lecturas y escrituras parten de cero.
+*/
+static void retomar_arbol(const string &archivo, ListaNodo &arr, int &raiz) {
+    DiskManager dm = DiskManager::open(archivo);
+    dm.cargar(arr);
+    raiz = dm.cabecera.raiz;
+}
+
+/*
+Un solo arbol B y un solo arbol B+ crecen a lo largo de todos los N: en cada potencia de dos se insertan solo
+los pares nuevos, se escribe el arbol a su archivo, se corren las consultas y se registran las metricas.
+IOs_insert y tiempo_insert_ms son acumulados desde el arbol vacio, asi que coinciden con construir cada N por separado.
+Con --reabrir, los arboles B y B+ ya escritos por una ejecucion anterior se reabren desde su superbloque
+en vez de construirse; si despues hay que seguir insertando, el arbol se carga desde el ultimo archivo reabierto
+y las metricas de insercion de ahi en adelante cuentan solo lo insertado desde ese punto.
+La columna amplificacion_escritura solo se llena en las filas LSM (paginas escritas por pagina de datos insertada).
+La fila "B paralelo" repite las consultas de la fila B con range_search_B_disk_paralelo sobre el mismo archivo.
+*/
+int main(int argc, char **argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
+    bool reabrir = argc > 1 && string(argv[1]) == "--reabrir";
+
     string datos_file = "datos.bin";
     ofstream out("resultados.csv");
-    out << "tipo,N,IOs_insert,nodos,tam_bytes,tiempo_busqueda_ms,IOs_busqueda,tiempo_insert_ms\n";
+    out << "tipo,N,IOs_insert,nodos,tam_bytes,tiempo_busqueda_ms,IOs_busqueda,tiempo_insert_ms,amplificacion_escritura\n";
+
+    vector<pair<int,float>> datos;
+    ListaNodo arrB, arrBp;
+    int root_idx_B = arrB.append(Nodo());
+    int root_idx_Bp = arrBp.append(Nodo());
+    size_t insertados_B = 0, insertados_Bp = 0;
+    double tiempo_acumulado_B = 0.0, tiempo_acumulado_Bp = 0.0;
+    string pendiente_B, pendiente_Bp;   // archivo reabierto que hay que cargar antes de seguir insertando
 
     for (int exp = 15; exp <= 26; exp++) {
         size_t N = 1ULL << exp;
         cout << "Ejecutando experimento con N=" << N << "\n";
+        vector<pair<int,float>> nuevos = leer_datos(datos_file, N - datos.size(), datos.size());
+        datos.insert(datos.end(), nuevos.begin(), nuevos.end());
 
         // =============== B-Tree ===============
-        vector<pair<int,float>> datosB = leer_datos(datos_file, N);
-        ListaNodo arrB;
+        DiskManager dmB("treeB_" + to_string(exp) + ".bin");
+        double tiempo_insert_ms;
+        size_t ios_insert, nodos;
         auto t1 = chrono::high_resolution_clock::now();
-        int root_idx_B = construir_arbol(arrB, datosB, false);
-        auto t2 = chrono::high_resolution_clock::now();
-        double tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+        auto t2 = t1;
+        if (reabrir && reabrir_arbol(dmB, false)) {
+            t2 = chrono::high_resolution_clock::now();
+            tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+            root_idx_B = dmB.cabecera.raiz;
+            ios_insert = dmB.reads;
+            nodos = dmB.cabecera.cantidad_nodos;
+            insertados_B = datos.size();
+            pendiente_B = dmB.filename;
+            cout << "[B] Reabierto desde " << dmB.filename << " en " << tiempo_insert_ms << " ms\n";
+        } else {
+            if (!pendiente_B.empty()) {
+                retomar_arbol(pendiente_B, arrB, root_idx_B);
+                pendiente_B.clear();
+            }
+            t1 = chrono::high_resolution_clock::now();
+            extender_arbol(arrB, root_idx_B, datos, insertados_B, false);
+            t2 = chrono::high_resolution_clock::now();
+            insertados_B = datos.size();
+            tiempo_acumulado_B += chrono::duration<double, milli>(t2 - t1).count();
+            tiempo_insert_ms = tiempo_acumulado_B;
+            cout << "[B] Construccion: " << tiempo_insert_ms << " ms, arena " << arrB.nodes.bytes_reservados()
+                 << " bytes, RSS " << rss_actual_bytes() << " bytes (pico " << rss_pico_bytes() << ")\n";
 
-        size_t ios_insert = arrB.reads + arrB.writes;
-        size_t nodos = arrB.size();
+            ios_insert = arrB.reads + arrB.writes;
+            nodos = arrB.size();
+            dmB.fijar_raiz(root_idx_B, false);
+            dmB.write_all(arrB);
+        }
         size_t tam_bytes = nodos * sizeof(Nodo);
 
-        DiskManager dmB("treeB_" + to_string(exp) + ".bin");
-        dmB.write_all(arrB);
-
         double sum_time = 0.0;
         size_t sum_ios = 0;
-        int io_busquedas = 0;
         mt19937 rng(42);
         uniform_int_distribution<int> distL(MIN_KEY, MAX_KEY - RANGE_SIZE);
         
@@ -46,6 +121,7 @@ int main() {
             int l = distL(rng);
             int u = l + RANGE_SIZE;
             vector<pair<int,float>> res;
+            int io_busquedas = 0;
             auto tq1 = chrono::high_resolution_clock::now();
             range_search_B_disk(dmB, root_idx_B, l, u, res, io_busquedas);
             auto tq2 = chrono::high_resolution_clock::now();
@@ -59,29 +135,81 @@ int main() {
         double avg_time = sum_time / Q;
         double avg_ios = double(sum_ios) / Q; 
         out << "B," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
-            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << "\n";
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << ",\n";
+
+        // =============== B Tree, busqueda paralela ===============
+        sum_time = 0.0;
+        sum_ios = 0;
+        mt19937 rng_paralelo(42);
+        for (int q = 0; q < Q; q++) {
+            int l = distL(rng_paralelo);
+            int u = l + RANGE_SIZE;
+            vector<pair<int,float>> res;
+            int io_busquedas = 0;
+            auto tq1 = chrono::high_resolution_clock::now();
+            range_search_B_disk_paralelo(dmB, root_idx_B, l, u, res, io_busquedas);
+            auto tq2 = chrono::high_resolution_clock::now();
+            sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+            double pct = 100.0 * res.size() / N;
+            sum_ios += io_busquedas;
+            cout << "[B paralelo] Consulta " << q << " -> " << res.size()
+                 << " resultados (" << pct << "%)" << ", ios_busqueda" << io_busquedas << "\n";
+        }
+
+        avg_time = sum_time / Q;
+        avg_ios = double(sum_ios) / Q;
+        out << "B paralelo," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << ",\n";
 
         // =============== B+ Tree ===============
-        vector<pair<int,float>> datosBp = leer_datos(datos_file, N);
-        ListaNodo arrBp;
+        DiskManager dmBp("treeBplus_" + to_string(exp) + ".bin");
         t1 = chrono::high_resolution_clock::now();
-        int root_idx_Bp = construir_arbol(arrBp, datosBp, true);
-        t2 = chrono::high_resolution_clock::now();
-        tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+        if (reabrir && reabrir_arbol(dmBp, true)) {
+            t2 = chrono::high_resolution_clock::now();
+            tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+            root_idx_Bp = dmBp.cabecera.raiz;
+            ios_insert = dmBp.reads;
+            nodos = dmBp.cabecera.cantidad_nodos;
+            insertados_Bp = datos.size();
+            pendiente_Bp = dmBp.filename;
+            cout << "[B+] Reabierto desde " << dmBp.filename << " en " << tiempo_insert_ms << " ms\n";
+        } else {
+            if (!pendiente_Bp.empty()) {
+                retomar_arbol(pendiente_Bp, arrBp, root_idx_Bp);
+                pendiente_Bp.clear();
+            }
+            t1 = chrono::high_resolution_clock::now();
+            extender_arbol(arrBp, root_idx_Bp, datos, insertados_Bp, true);
+            t2 = chrono::high_resolution_clock::now();
+            insertados_Bp = datos.size();
+            tiempo_acumulado_Bp += chrono::duration<double, milli>(t2 - t1).count();
+            tiempo_insert_ms = tiempo_acumulado_Bp;
+            cout << "[B+] Construccion: " << tiempo_insert_ms << " ms, arena " << arrBp.nodes.bytes_reservados()
+                 << " bytes, RSS " << rss_actual_bytes() << " bytes (pico " << rss_pico_bytes() << ")\n";
 
-        ios_insert = arrBp.reads + arrBp.writes;
-        nodos = arrBp.size();
+            ios_insert = arrBp.reads + arrBp.writes;
+            nodos = arrBp.size();
+            // Hojas contiguas en orden de llave: la cadena de hojas se lee en forma secuencial.
+            // La reubicacion no es parte de la insercion, asi que no suma a los contadores del arbol.
+            uint64_t lecturas = arrBp.reads, escrituras = arrBp.writes;
+            relayout(arrBp, root_idx_Bp, true);
+            arrBp.reads = lecturas;
+            arrBp.writes = escrituras;
+            dmBp.fijar_raiz(root_idx_Bp, true);
+            dmBp.write_all(arrBp);
+        }
         tam_bytes = nodos * sizeof(Nodo);
 
-        DiskManager dmBp("treeBplus_" + to_string(exp) + ".bin");
-        dmBp.write_all(arrBp);
-
         sum_time = 0.0;
         sum_ios = 0;
-        io_busquedas = 0;
+        mt19937 rng_aprendido = rng; // el indice aprendido se consulta con las mismas ventanas que el B+
+        mt19937 rng_particionado = rng;
+        mt19937 rng_lsm = rng;
+        mt19937 rng_eytzinger = rng;
         for (int q = 0; q < Q; q++) {
             int l = distL(rng);
             int u = l + RANGE_SIZE;
+            int io_busquedas = 0;
             auto tq1 = chrono::high_resolution_clock::now();
             auto res = range_search_Bplus_disk(dmBp, root_idx_Bp, l, u, io_busquedas);
             auto tq2 = chrono::high_resolution_clock::now();
@@ -95,7 +223,178 @@ int main() {
         avg_time = sum_time / Q;
         avg_ios = double(sum_ios) / Q; 
         out << "B+," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
-            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << "\n";
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << ",\n";
+
+        // =============== B+ con indice Eytzinger ===============
+        // Los niveles internos se reemplazan por el indice en memoria; solo se leen las hojas del archivo del B+.
+        // Un arbol reabierto se carga completo para armar el indice (esa carga no se mide).
+        ListaNodo cargado;
+        const ListaNodo *arbol_Bp = &arrBp;
+        if (!pendiente_Bp.empty()) {
+            DiskManager::open(pendiente_Bp).cargar(cargado);
+            arbol_Bp = &cargado;
+        }
+        t1 = chrono::high_resolution_clock::now();
+        IndiceEytzinger indiceE = construir_eytzinger(*arbol_Bp, root_idx_Bp);
+        t2 = chrono::high_resolution_clock::now();
+        double tiempo_eytzinger_ms = chrono::duration<double, milli>(t2 - t1).count();
+        size_t tam_eytzinger = (indiceE.separadores.size() + indiceE.hojas.size()) * sizeof(int);
+        cout << "[B+ eytzinger] " << indiceE.separadores.size() - 1 << " separadores, indice de " << tam_eytzinger
+             << " bytes, construccion: " << tiempo_eytzinger_ms << " ms\n";
+        cargado = ListaNodo();
+
+        sum_time = 0.0;
+        sum_ios = 0;
+        for (int q = 0; q < Q; q++) {
+            int l = distL(rng_eytzinger);
+            int u = l + RANGE_SIZE;
+            int io_busquedas = 0;
+            auto tq1 = chrono::high_resolution_clock::now();
+            auto res = range_search_Bplus_eytzinger(dmBp, indiceE, l, u, io_busquedas);
+            auto tq2 = chrono::high_resolution_clock::now();
+            sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+            double pct = 100.0 * res.size() / N;
+            sum_ios += io_busquedas;
+            cout << "[B+ eytzinger] Consulta " << q << " -> " << res.size()
+                 << " resultados (" << pct << "%)" << ", ios_busqueda" << io_busquedas << "\n";
+        }
+
+        avg_time = sum_time / Q;
+        avg_ios = double(sum_ios) / Q;
+        out << "B+ eytzinger," << N << "," << ios_insert << "," << nodos << "," << tam_bytes + tam_eytzinger
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms + tiempo_eytzinger_ms << ",\n";
+
+        // =============== B+ con cache de rangos ===============
+        // Ventanas de una semana que se deslizan de a un dia, como un dashboard: cada consulta solo deberia leer el dia nuevo.
+        CacheRangos cache;
+        uniform_int_distribution<int> distV(MIN_KEY, MAX_KEY - RANGE_SIZE - (Q - 1) * PASO_VENTANA);
+        int inicio_ventana = distV(rng);
+        sum_time = 0.0;
+        sum_ios = 0;
+        for (int q = 0; q < Q; q++) {
+            int l = inicio_ventana + q * PASO_VENTANA;
+            int u = l + RANGE_SIZE;
+            int io_busquedas = 0;
+            auto tq1 = chrono::high_resolution_clock::now();
+            auto res = range_search_Bplus_disk(dmBp, root_idx_Bp, cache, l, u, io_busquedas);
+            auto tq2 = chrono::high_resolution_clock::now();
+            sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+            double pct = 100.0 * res.size() / N;
+            sum_ios += io_busquedas;
+            cout << "[B+ cache] Consulta " << q << " -> " << res.size()
+                 << " resultados (" << pct << "%)" << ", ios_busqueda" << io_busquedas << "\n";
+        }
+        cout << "[B+ cache] " << cache.consultas_completas << " de " << cache.consultas << " consultas sin leer el arbol, "
+             << cache.pares_guardados << " pares guardados\n";
+
+        avg_time = sum_time / Q;
+        avg_ios = double(sum_ios) / Q;
+        out << "B+ cache," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << ",\n";
+
+        // =============== B+ particionado ===============
+        int particiones = max(1u, thread::hardware_concurrency());
+        IndiceParticionado indiceP(cortes_cuantiles(datos, particiones), "treeBplusP_" + to_string(exp));
+        t1 = chrono::high_resolution_clock::now();
+        indiceP.insertar_lote(datos);
+        t2 = chrono::high_resolution_clock::now();
+        tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+        cout << "[B+ particionado] " << particiones << " particiones, construccion: " << tiempo_insert_ms << " ms\n";
+
+        ios_insert = indiceP.ios();
+        nodos = indiceP.nodos();
+        tam_bytes = nodos * sizeof(Nodo);
+        indiceP.write_all();
+
+        sum_time = 0.0;
+        sum_ios = 0;
+        for (int q = 0; q < Q; q++) {
+            int l = distL(rng_particionado);
+            int u = l + RANGE_SIZE;
+            int io_busquedas = 0;
+            auto tq1 = chrono::high_resolution_clock::now();
+            auto res = indiceP.range_search(l, u, io_busquedas);
+            auto tq2 = chrono::high_resolution_clock::now();
+            sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+            double pct = 100.0 * res.size() / N;
+            sum_ios += io_busquedas;
+            cout << "[B+ particionado] Consulta " << q << " -> " << res.size()
+                 << " resultados (" << pct << "%)" << ", ios_busqueda" << io_busquedas << "\n";
+        }
+
+        avg_time = sum_time / Q;
+        avg_ios = double(sum_ios) / Q;
+        out << "B+ particionado," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << ",\n";
+
+        // =============== LSM ===============
+        ArbolLSM lsm("lsm_" + to_string(exp));
+        t1 = chrono::high_resolution_clock::now();
+        for (auto &p : datos) lsm.insert(p.first, p.second);
+        lsm.flush();
+        t2 = chrono::high_resolution_clock::now();
+        tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+        cout << "[LSM] " << lsm.niveles.size() << " niveles, amplificacion de escritura "
+             << lsm.amplificacion_escritura() << ", construccion: " << tiempo_insert_ms << " ms\n";
+
+        ios_insert = lsm.paginas_escritas + lsm.paginas_leidas;
+        nodos = lsm.paginas();
+        tam_bytes = nodos * sizeof(Nodo);
+
+        sum_time = 0.0;
+        sum_ios = 0;
+        for (int q = 0; q < Q; q++) {
+            int l = distL(rng_lsm);
+            int u = l + RANGE_SIZE;
+            int io_busquedas = 0;
+            auto tq1 = chrono::high_resolution_clock::now();
+            auto res = lsm.range_search(l, u, io_busquedas);
+            auto tq2 = chrono::high_resolution_clock::now();
+            sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+            double pct = 100.0 * res.size() / N;
+            sum_ios += io_busquedas;
+            cout << "[LSM] Consulta " << q << " -> " << res.size()
+                 << " resultados (" << pct << "%)" << ", ios_busqueda" << io_busquedas << "\n";
+        }
+
+        avg_time = sum_time / Q;
+        avg_ios = double(sum_ios) / Q;
+        out << "LSM," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << "," << lsm.amplificacion_escritura() << "\n";
+
+        // =============== Indice aprendido ===============
+        DiskManager dmA("aprendido_" + to_string(exp) + ".bin");
+        t1 = chrono::high_resolution_clock::now();
+        IndiceAprendido indiceA = construir_aprendido(datos, dmA);
+        t2 = chrono::high_resolution_clock::now();
+        tiempo_insert_ms = chrono::duration<double, milli>(t2 - t1).count();
+
+        ios_insert = dmA.writes;
+        nodos = indiceA.paginas;
+        tam_bytes = nodos * sizeof(Nodo) + indiceA.tam_modelo_bytes();
+        cout << "[Aprendido] " << indiceA.segmentos.size() << " segmentos, modelo de "
+             << indiceA.tam_modelo_bytes() << " bytes\n";
+
+        sum_time = 0.0;
+        sum_ios = 0;
+        for (int q = 0; q < Q; q++) {
+            int l = distL(rng_aprendido);
+            int u = l + RANGE_SIZE;
+            int io_busquedas = 0;
+            auto tq1 = chrono::high_resolution_clock::now();
+            auto res = range_search_aprendido_disk(dmA, indiceA, l, u, io_busquedas);
+            auto tq2 = chrono::high_resolution_clock::now();
+            sum_time += chrono::duration<double, milli>(tq2 - tq1).count();
+            double pct = 100.0 * res.size() / N;
+            sum_ios += io_busquedas;
+            cout << "[Aprendido] Consulta " << q << " -> " << res.size()
+                 << " resultados (" << pct << "%)" << ", ios_busqueda" << io_busquedas << "\n";
+        }
+
+        avg_time = sum_time / Q;
+        avg_ios = double(sum_ios) / Q;
+        out << "Aprendido," << N << "," << ios_insert << "," << nodos << "," << tam_bytes
+            << "," << avg_time << "," << avg_ios << "," << tiempo_insert_ms << ",\n";
     }
     return 0;
 }
@@ -1,36 +1,345 @@
 #include "manejodisco.h"
 #include <fstream>
 #include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 
+/*
+ColaLecturas :: struct
+Hilos lectores persistentes sobre un archivo de nodos, cada uno con su propio descriptor.
+Los pedidos (etiqueta, indice) entran a una cola; cada lector toma uno, lo lee y deja el resultado en la cola de
+completadas en el orden en que terminan, asi quien espera puede procesar cada nodo apenas llega.
+Una lectura que no trae la pagina completa (archivo que no abre, pagina fuera del archivo) queda marcada como fallida.
+en_vuelo cuenta los pedidos hechos que aun no se sacan de completadas.
+*/
+struct ColaLecturas {
+    struct Pedido { int etiqueta; int idx; };
+    struct Completada { int etiqueta; int idx; bool ok; Nodo nodo; };
+
+    string filename;
+    int profundidad;
+    mutex m;
+    condition_variable hay_pedidos, hay_completadas;
+    deque<Pedido> pedidos;
+    deque<Completada> completadas;
+    int en_vuelo = 0;
+    bool detener = false;
+    vector<thread> lectores;
+
+    ColaLecturas(string fname, int profundidad_cola): filename(move(fname)), profundidad(profundidad_cola) {
+        for (int h = 0; h < profundidad; ++h) lectores.emplace_back([this] { leer(); });
+    }
+
+    ~ColaLecturas() {
+        {
+            lock_guard<mutex> lock(m);
+            detener = true;
+        }
+        hay_pedidos.notify_all();
+        for (auto &t : lectores) t.join();
+    }
+
+    void leer() {
+        ifstream ifs(filename, ios::binary);
+        while (true) {
+            Pedido p;
+            {
+                unique_lock<mutex> lock(m);
+                hay_pedidos.wait(lock, [this] { return detener || !pedidos.empty(); });
+                if (detener) return;
+                p = pedidos.front();
+                pedidos.pop_front();
+            }
+            Completada c{p.etiqueta, p.idx, false, Nodo()};
+            if (!ifs.is_open()) ifs.open(filename, ios::binary);
+            ifs.clear();
+            ifs.seekg((std::streamoff)(p.idx + 1) * sizeof(Nodo), ios::beg);
+            ifs.read(reinterpret_cast<char*>(&c.nodo), sizeof(Nodo));
+            c.ok = ifs.gcount() == (std::streamsize)sizeof(Nodo);
+            {
+                lock_guard<mutex> lock(m);
+                completadas.push_back(c);
+            }
+            hay_completadas.notify_all();
+        }
+    }
+
+    void pedir(int etiqueta, int idx) {
+        {
+            lock_guard<mutex> lock(m);
+            pedidos.push_back({etiqueta, idx});
+            en_vuelo++;
+        }
+        hay_pedidos.notify_one();
+    }
+
+    Completada esperar() {
+        unique_lock<mutex> lock(m);
+        if (en_vuelo == 0) throw runtime_error("No hay lecturas pendientes en " + filename);
+        hay_completadas.wait(lock, [this] { return !completadas.empty(); });
+        Completada c = completadas.front();
+        completadas.pop_front();
+        en_vuelo--;
+        return c;
+    }
+
+    /*
+    descartar :: -> Void
+    Saca los pedidos que aun no empiezan, espera a que terminen los que se estan leyendo y bota sus resultados.
+    Deja la cola vacia para el siguiente uso despues de una lectura fallida.
+    */
+    void descartar() {
+        unique_lock<mutex> lock(m);
+        en_vuelo -= (int)pedidos.size();
+        pedidos.clear();
+        hay_completadas.wait(lock, [this] { return (int)completadas.size() == en_vuelo; });
+        completadas.clear();
+        en_vuelo = 0;
+    }
+
+    bool sin_pendientes() {
+        lock_guard<mutex> lock(m);
+        return en_vuelo == 0;
+    }
+};
+
 DiskManager::DiskManager(string fname): filename(move(fname)) {}
 
 /*
-write_all :: ListaNodo -> Void
+open :: String -> DiskManager
+Reabre un archivo de nodos existente leyendo solo su superbloque (una lectura).
+Lanza runtime_error si el archivo no existe o no fue escrito con este formato, tamaño de pagina y B.
+*/
+DiskManager DiskManager::open(const string &fname) {
+    DiskManager dm(fname);
+    ifstream ifs(fname, ios::binary);
+    if (!ifs) throw runtime_error("No se pudo abrir archivo para lectura: " + fname);
+    Superbloque sb;
+    ifs.read(reinterpret_cast<char*>(&sb), sizeof(Superbloque));
+    if (!ifs || sb.magico != Magico_superbloque) throw runtime_error("Archivo sin superbloque: " + fname);
+    if (sb.version != Version_superbloque) throw runtime_error("Version de superbloque no soportada: " + fname);
+    if (sb.tam_pagina != sizeof(Nodo) || sb.orden != (uint32_t)B) {
+        throw runtime_error("Archivo escrito con otro tamaño de pagina o B: " + fname);
+    }
+    dm.cabecera = sb;
+    dm.reads++;
+    return dm;
+}
+
+/*
+fijar_raiz :: Int, Bool -> Void
+Fija la raiz y el tipo de arbol que se guardaran en el superbloque en la proxima escritura.
+*/
+void DiskManager::fijar_raiz(int raiz, bool es_Bplus) {
+    cabecera.raiz = raiz;
+    cabecera.es_Bplus = es_Bplus;
+}
+
+/*
+actualizar_cabecera :: Superbloque, ListaNodo -> Void
+Completa el superbloque con la cantidad de nodos, la altura (bajando por el hijo izquierdo desde la raiz) y las posiciones libres.
+Las entradas de libres que no se usan quedan en cero, para no escribir memoria sin inicializar al archivo.
+*/
+static void actualizar_cabecera(Superbloque &sb, const ListaNodo &arr) {
+    sb.cantidad_nodos = arr.size();
+    sb.altura = 0;
+    int idx = sb.raiz;
+    while (idx >= 0 && idx < arr.size()) {
+        sb.altura++;
+        const Nodo &n = arr.nodes[idx];
+        if (!n.es_interno) break;
+        idx = n.hijos[0];
+    }
+    sb.cantidad_libres = min<int>((int)arr.libres.size(), Capacidad_libres);
+    for (int i = 0; i < sb.cantidad_libres; ++i) sb.libres[i] = arr.libres[i];
+    fill(sb.libres + sb.cantidad_libres, sb.libres + Capacidad_libres, 0);
+}
+
+/*
+cargar :: ListaNodo -> Void
+Lee el archivo completo a la ListaNodo (reemplazando su contenido) para seguir insertando sobre un arbol reabierto.
+Restaura las posiciones libres del superbloque y deja en -1 el campo siguiente de los nodos internos.
+*/
+void DiskManager::cargar(ListaNodo &arr) {
+    ifstream ifs(filename, ios::binary);
+    if (!ifs) throw runtime_error("No se pudo abrir archivo para lectura: " + filename);
+    arr = ListaNodo();
+    ifs.seekg((std::streamoff)sizeof(Superbloque), ios::beg);
+    for (int i = 0; i < cabecera.cantidad_nodos; ++i) {
+        Nodo n;
+        ifs.read(reinterpret_cast<char*>(&n), sizeof(Nodo));
+        if (!ifs) throw runtime_error("Archivo truncado: " + filename);
+        if (n.es_interno) n.siguiente = -1;
+        arr.nodes.push_back(n);
+        reads++;
+    }
+    arr.libres.assign(cabecera.libres, cabecera.libres + cabecera.cantidad_libres);
+}
+
+/*
+write_all :: ListaNodo, Agregados* -> Void
 Escribe todos los nodos de la lista de nodos al archivo en disco.
+Si se entregan agregados, escribe tambien el archivo lateral con los resumenes de los hijos de cada nodo interno.
+Antes de los nodos escribe el superbloque con la raiz fijada por fijar_raiz.
 */
-void DiskManager::write_all(const ListaNodo &arr) {
+void DiskManager::write_all(const ListaNodo &arr, const Agregados *agregados) {
     ofstream ofs(filename, ios::binary | ios::out | ios::trunc);
     if (!ofs) throw runtime_error("No se pudo abrir archivo para escribir: " + filename);
+    ofstream ofs_agg;
+    if (agregados != nullptr) {
+        ofs_agg.open(filename + ".agg", ios::binary | ios::out | ios::trunc);
+        if (!ofs_agg) throw runtime_error("No se pudo abrir archivo para escribir: " + filename + ".agg");
+    }
+    cabecera.tiene_agregados = agregados != nullptr;
+    actualizar_cabecera(cabecera, arr);
+    ofs.write(reinterpret_cast<const char*>(&cabecera), sizeof(Superbloque));
+    writes++;
+    int bloques = 0;
     for (int i = 0; i < arr.size(); ++i) {
-        const Nodo &n = arr.nodes[i];
+        Nodo n = arr.nodes[i];
+        if (agregados != nullptr && n.es_interno) {
+            BloqueResumen bloque;
+            for (int j = 0; j <= n.k; ++j)
+                if (n.hijos[j] != -1 && n.hijos[j] < (int)agregados->por_nodo.size())
+                    bloque.hijos[j] = agregados->por_nodo[n.hijos[j]];
+            ofs_agg.write(reinterpret_cast<const char*>(&bloque), sizeof(BloqueResumen));
+            writes += Paginas_bloque_resumen;
+            n.siguiente = bloques++;
+        }
         ofs.write(reinterpret_cast<const char*>(&n), sizeof(Nodo));
         writes++;
     }
     ofs.close();
 }
 
+/*
+write_pages :: ListaNodo, vector<Int>, Agregados* -> Void
+Escribe en su lugar solo los nodos indicados, sin truncar el archivo (lo crea si no existe).
+Si se entregan agregados, cada nodo interno escrito recibe un bloque de resumenes nuevo al final del archivo lateral:
+los bloques existentes no se sobrescriben porque pueden ser de paginas de un snapshot (el archivo lateral solo crece).
+El superbloque se reescribe al final, despues de los nodos, para que no apunte a paginas que aun no estan en disco.
+*/
+void DiskManager::write_pages(const ListaNodo &arr, const vector<int> &indices, const Agregados *agregados) {
+    fstream fs(filename, ios::binary | ios::in | ios::out);
+    if (!fs) fs.open(filename, ios::binary | ios::out | ios::trunc);
+    if (!fs) throw runtime_error("No se pudo abrir archivo para escribir: " + filename);
+    ofstream ofs_agg;
+    int bloques = 0;
+    if (agregados != nullptr) {
+        ofs_agg.open(filename + ".agg", ios::binary | ios::out | ios::app);
+        if (!ofs_agg) throw runtime_error("No se pudo abrir archivo para escribir: " + filename + ".agg");
+        ofs_agg.seekp(0, ios::end);
+        bloques = (int)(ofs_agg.tellp() / (std::streamoff)sizeof(BloqueResumen));
+        cabecera.tiene_agregados = 1;
+    }
+    for (int idx : indices) {
+        Nodo n = arr.nodes[idx];
+        if (agregados != nullptr && n.es_interno) {
+            BloqueResumen bloque;
+            for (int j = 0; j <= n.k; ++j)
+                if (n.hijos[j] != -1 && n.hijos[j] < (int)agregados->por_nodo.size())
+                    bloque.hijos[j] = agregados->por_nodo[n.hijos[j]];
+            ofs_agg.write(reinterpret_cast<const char*>(&bloque), sizeof(BloqueResumen));
+            writes += Paginas_bloque_resumen;
+            n.siguiente = bloques++;
+        }
+        fs.seekp((std::streamoff)(idx + 1) * sizeof(Nodo), ios::beg);
+        fs.write(reinterpret_cast<const char*>(&n), sizeof(Nodo));
+        writes++;
+    }
+    if (ofs_agg.is_open()) ofs_agg.close();
+    fs.flush();
+    actualizar_cabecera(cabecera, arr);
+    fs.seekp(0, ios::beg);
+    fs.write(reinterpret_cast<const char*>(&cabecera), sizeof(Superbloque));
+    writes++;
+    fs.close();
+}
+
 /*
 read_node_at :: Int -> Nodo
-Lee el nodo en la posición idx del archivo en disco.
+Lee el nodo en la posición idx del archivo en disco (pagina idx + 1, despues del superbloque).
 */
 Nodo DiskManager::read_node_at(int idx) {
     ifstream ifs(filename, ios::binary);
     if (!ifs) throw runtime_error("No se pudo abrir archivo para lectura: " + filename);
-    ifs.seekg((std::streamoff)idx * sizeof(Nodo), ios::beg);
+    ifs.seekg((std::streamoff)(idx + 1) * sizeof(Nodo), ios::beg);
     Nodo n;
     ifs.read(reinterpret_cast<char*>(&n), sizeof(Nodo));
-    ifs.close();
     reads++;
+    if (!ifs) throw runtime_error("Lectura incompleta del nodo " + to_string(idx) + " en " + filename);
     return n;
 }
+
+/*
+pedir_lectura :: Int, Int, Int -> Void
+Encola la lectura del nodo idx con una etiqueta para reconocerlo al completarse, sin esperarla.
+La primera llamada crea el grupo de profundidad_cola hilos lectores; se recrea con otra profundidad solo si no hay
+lecturas pendientes.
+*/
+void DiskManager::pedir_lectura(int idx, int etiqueta, int profundidad_cola) {
+    profundidad_cola = max(1, profundidad_cola);
+    if (!cola_lecturas || (cola_lecturas->profundidad != profundidad_cola && cola_lecturas->sin_pendientes())) {
+        cola_lecturas = make_shared<ColaLecturas>(filename, profundidad_cola);
+    }
+    cola_lecturas->pedir(etiqueta, idx);
+}
+
+/*
+esperar_lectura :: -> LecturaCompletada
+Devuelve la siguiente lectura que termine (no necesariamente en el orden en que se pidieron) y cuenta una lectura.
+Si la lectura fallo, descarta las demas pendientes y lanza runtime_error; tambien lanza si no hay nada pedido.
+*/
+LecturaCompletada DiskManager::esperar_lectura() {
+    if (!cola_lecturas) throw runtime_error("No hay lecturas pendientes en " + filename);
+    ColaLecturas::Completada c = cola_lecturas->esperar();
+    reads++;
+    if (!c.ok) {
+        cola_lecturas->descartar();
+        throw runtime_error("Lectura incompleta del nodo " + to_string(c.idx) + " en " + filename);
+    }
+    return {c.etiqueta, c.nodo};
+}
+
+/*
+read_nodes :: vector<Int>, Int -> vector<Nodo>
+Lee varios nodos independientes a la vez: los pide todos a la cola de lecturas (hasta profundidad_cola en vuelo)
+y devuelve los nodos en el mismo orden que los indices. Cuenta una lectura por nodo y lanza si alguna falla.
+*/
+vector<Nodo> DiskManager::read_nodes(const vector<int> &indices, int profundidad_cola) {
+    vector<Nodo> nodos(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) pedir_lectura(indices[i], (int)i, profundidad_cola);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        LecturaCompletada lectura = esperar_lectura();
+        nodos[lectura.etiqueta] = lectura.nodo;
+    }
+    return nodos;
+}
+
+/*
+read_summary_block :: Int -> BloqueResumen
+Lee del archivo lateral de agregados el bloque con los resumenes de los hijos de un nodo interno.
+Cuenta como Paginas_bloque_resumen lecturas.
+*/
+BloqueResumen DiskManager::read_summary_block(int bloque) {
+    ifstream ifs(filename + ".agg", ios::binary);
+    if (!ifs) throw runtime_error("No se pudo abrir archivo para lectura: " + filename + ".agg");
+    ifs.seekg((std::streamoff)bloque * sizeof(BloqueResumen), ios::beg);
+    BloqueResumen b;
+    ifs.read(reinterpret_cast<char*>(&b), sizeof(BloqueResumen));
+    reads += Paginas_bloque_resumen;
+    if (!ifs) throw runtime_error("Lectura incompleta del bloque " + to_string(bloque) + " en " + filename + ".agg");
+    return b;
+}
+
+/*
+exigir_hojas_enlazadas :: -> Void
+Lanza runtime_error si el archivo se escribio sin mantener la cadena de hojas (ver Superbloque::hojas_enlazadas).
+La llaman las busquedas que recorren las hojas por siguiente o anterior; las que bajan por el arbol no la necesitan.
+*/
+void DiskManager::exigir_hojas_enlazadas() const {
+    if (!cabecera.hojas_enlazadas)
+        throw runtime_error("La cadena de hojas de " + filename + " no se mantiene con copy-on-write; use range_search_tree_disk");
+}
@@ -3,21 +3,89 @@
 
 #include "nodo.h"
 #include "listanodo.h"
+#include "agregados.h"
 
+/*
+Identificacion del formato del archivo de nodos.
+*/
+constexpr uint32_t Magico_superbloque = 0x41474F4C; // "LOGA"
+constexpr uint32_t Version_superbloque = 2;
+constexpr int Capacidad_libres = (int)(sizeof(Nodo) - 11 * sizeof(int32_t)) / (int)sizeof(int32_t);
+
+/*
+Superbloque :: struct
+Primera pagina del archivo de nodos: describe el arbol para poder reabrirlo sin reconstruirlo.
+Guarda el tamaño de pagina y B con que se escribio (un archivo de otra compilacion se rechaza), el tipo de arbol,
+la raiz, la altura, la cantidad de nodos y la lista de posiciones libres. Si hay mas de Capacidad_libres posiciones
+libres solo se guardan las primeras; las demas quedan como paginas sin usar en el archivo.
+hojas_enlazadas es 0 si el archivo se escribio con copy-on-write (ver VersionesArbol::flush): ahi los enlaces siguiente
+y anterior de las hojas pueden apuntar a paginas retiradas o reutilizadas, y las busquedas que siguen la cadena de hojas
+lanzan runtime_error en vez de devolver datos de otra pagina.
+*/
+struct Superbloque {
+    uint32_t magico = Magico_superbloque;
+    uint32_t version = Version_superbloque;
+    uint32_t tam_pagina = sizeof(Nodo);
+    uint32_t orden = B;
+    int32_t es_Bplus = 0;
+    int32_t raiz = -1;
+    int32_t altura = 0;
+    int32_t cantidad_nodos = 0;
+    int32_t tiene_agregados = 0;
+    int32_t cantidad_libres = 0;
+    int32_t hojas_enlazadas = 1;
+    int32_t libres[Capacidad_libres];
+};
+static_assert(sizeof(Superbloque) == sizeof(Nodo), "El superbloque debe ocupar exactamente una pagina");
+
+/*
+ColaLecturas :: struct
+Grupo persistente de hilos lectores con una cola de pedidos y una cola de lecturas completadas (ver manejodisco.cpp).
+*/
+struct ColaLecturas;
+
+/*
+LecturaCompletada :: struct
+Nodo leido por la cola de lecturas, junto con la etiqueta con que se pidio.
+*/
+struct LecturaCompletada {
+    int etiqueta;
+    Nodo nodo;
+};
 
 /*
 DiskManager :: struct
 Estructura que maneja la lectura y escritura de nodos en disco.
 Contiene el nombre del archivo y contadores de lecturas y escrituras.
+Si el arbol lleva agregados, se escribe ademas un archivo lateral (filename + ".agg") con un BloqueResumen por nodo interno;
+en el archivo de nodos, el campo siguiente de cada nodo interno (que no se usa para encadenar) guarda el numero de su bloque.
+La pagina 0 del archivo es el Superbloque; el nodo idx vive en la pagina idx + 1. La raiz y el tipo de arbol que se
+guardan en el superbloque se fijan con fijar_raiz antes de escribir, y open reabre un archivo existente leyendo solo esa pagina.
+read es read_node_at con el nombre de los almacenes (ver almacen.h), para usar las busquedas en plantilla sobre el archivo.
+pedir_lectura y esperar_lectura usan un grupo de hilos lectores que se crea en el primer pedido y vive lo que el DiskManager
+(las copias lo comparten); read_nodes es un lote de pedidos sobre ese mismo grupo.
 */
 struct DiskManager {
     std::string filename;
     mutable uint64_t reads = 0;
     mutable uint64_t writes = 0;
 
+    Superbloque cabecera{};
+    std::shared_ptr<ColaLecturas> cola_lecturas;
+
     DiskManager(std::string fname);
-    void write_all(const ListaNodo &arr);
+    static DiskManager open(const std::string &fname);
+    void fijar_raiz(int raiz, bool es_Bplus);
+    void cargar(ListaNodo &arr);
+    void write_all(const ListaNodo &arr, const Agregados *agregados = nullptr);
+    void write_pages(const ListaNodo &arr, const std::vector<int> &indices, const Agregados *agregados = nullptr);
     Nodo read_node_at(int idx);
+    Nodo read(int idx) { return read_node_at(idx); }
+    std::vector<Nodo> read_nodes(const std::vector<int> &indices, int queue_depth);
+    void pedir_lectura(int idx, int etiqueta, int queue_depth);
+    LecturaCompletada esperar_lectura();
+    BloqueResumen read_summary_block(int bloque);
+    void exigir_hojas_enlazadas() const;
 };
 
 #endif
@@ -16,10 +16,19 @@ struct LlaveValor {
     float valor;
 };
 
+/*
+es_lapida :: LlaveValor -> Bool
+Un par borrado no se saca del nodo de inmediato, sino que se marca como lapida dejando su valor en NaN.
+La llave se conserva para que el nodo siga ordenado y sirva de separador hasta la compactacion.
+*/
+inline bool es_lapida(const LlaveValor &par) { return std::isnan(par.valor); }
+inline void marcar_lapida(LlaveValor &par) { par.valor = std::numeric_limits<float>::quiet_NaN(); }
+
 /*
 Nodo :: struct
 Estructura que representa un nodo en un árbol B o B+.
 Contiene un arreglo de pares llave-valor, un arreglo de hijos, un indicador de si es interno o hoja, y un índice al siguiente nodo hoja (solo para B+).
+Las hojas no usan el arreglo de hijos, asi que hijos[B] guarda el índice de la hoja anterior (ver anterior).
 */
 struct Nodo {
     int es_interno;
@@ -31,6 +40,13 @@ struct Nodo {
     Nodo();
 };
 
+/*
+anterior :: Nodo -> Int&
+Enlace hacia atras de una hoja (-1 si es la primera). Vive en hijos[B], que una hoja no usa, para no agrandar el nodo.
+*/
+inline int &anterior(Nodo &hoja) { return hoja.hijos[B]; }
+inline int anterior(const Nodo &hoja) { return hoja.hijos[B]; }
+
 /*
 Verifica que el tamaño de la estructura Nodo sea igual a Bytes_nodo (4096 bytes).
 */
@@ -0,0 +1,140 @@
+#include "particiones.h"
+#include "busqueda.h"
+#include <thread>
+using namespace std;
+
+/*
+IndiceParticionado :: vector<Int>, String, OpcionesArbol -> IndiceParticionado
+Crea cortes.size() + 1 arboles B+ vacios; el archivo de la particion i es prefijo + "_" + i + ".bin".
+Las opciones se aplican a cada particion por separado, por lo que no pueden llevar agregados, versiones, indice hash
+ni cache de rangos (esas estructuras son de un solo arbol y no se pueden compartir entre hilos; el hash ademas
+mezclaria numeros de hoja de distintas particiones).
+*/
+IndiceParticionado::IndiceParticionado(const vector<int> &cortes_, const string &prefijo, const OpcionesArbol &opciones_)
+    : cortes(cortes_), opciones(opciones_) {
+    if (!is_sorted(cortes.begin(), cortes.end())) {
+        throw runtime_error("Cortes desordenados en IndiceParticionado");
+    }
+    if (opciones.agregados != nullptr || opciones.versiones != nullptr || opciones.hash != nullptr
+        || opciones.cache != nullptr) {
+        throw runtime_error("IndiceParticionado no admite agregados, versiones, indice hash ni cache compartidos");
+    }
+    int k = (int)cortes.size() + 1;
+    arboles.resize(k);
+    raices.resize(k);
+    for (int i = 0; i < k; i++) {
+        raices[i] = arboles[i].append(Nodo());
+        discos.emplace_back(prefijo + "_" + to_string(i) + ".bin");
+    }
+}
+
+/*
+particion_de :: Int -> Int
+Devuelve la particion a la que pertenece la llave.
+*/
+int IndiceParticionado::particion_de(int llave) const {
+    return (int)(upper_bound(cortes.begin(), cortes.end(), llave) - cortes.begin());
+}
+
+/*
+insertar :: Int, Float -> Void
+Inserta un par en el arbol de su particion (en el hilo actual).
+*/
+void IndiceParticionado::insertar(int llave, float valor) {
+    int p = particion_de(llave);
+    insert(arboles[p], raices[p], llave, valor, true, opciones);
+}
+
+/*
+insertar_lote :: vector<pair<Int,Float>> -> Void
+Reparte los pares por particion manteniendo su orden de llegada y lanza un hilo por particion con pares.
+Cada hilo solo toca su propio ListaNodo y su raiz, asi que no hay datos compartidos entre hilos.
+*/
+void IndiceParticionado::insertar_lote(const vector<pair<int,float>> &datos) {
+    vector<vector<pair<int,float>>> lotes(cantidad());
+    for (auto &p : datos) lotes[particion_de(p.first)].push_back(p);
+
+    vector<thread> hilos;
+    for (int i = 0; i < cantidad(); i++) {
+        if (lotes[i].empty()) continue;
+        hilos.emplace_back([this, i, &lotes]() {
+            for (auto &p : lotes[i]) insert(arboles[i], raices[i], p.first, p.second, true, opciones);
+        });
+    }
+    for (auto &h : hilos) h.join();
+}
+
+/*
+write_all :: -> Void
+Escribe cada particion en su archivo.
+*/
+void IndiceParticionado::write_all() {
+    for (int i = 0; i < cantidad(); i++) {
+        discos[i].fijar_raiz(raices[i], true);
+        discos[i].write_all(arboles[i]);
+    }
+}
+
+/*
+range_search :: Int, Int, Int -> vector<pair<Int,Float>>
+Busca [l, u] solo en las particiones que lo solapan (de particion_de(l) a particion_de(u)).
+Como las particiones estan ordenadas y no se solapan, concatenar sus resultados en orden ya deja todo ordenado por llave.
+*/
+vector<pair<int,float>> IndiceParticionado::range_search(int l, int u, int &io_busquedas) {
+    vector<pair<int,float>> out;
+    if (l > u) return out;
+    int desde = particion_de(l), hasta = particion_de(u);
+    for (int i = desde; i <= hasta; i++) {
+        auto res = range_search_Bplus_disk(discos[i], raices[i], l, u, io_busquedas);
+        out.insert(out.end(), res.begin(), res.end());
+    }
+    return out;
+}
+
+/*
+ios :: -> Int
+Suma de lecturas y escrituras en memoria de todas las particiones.
+*/
+uint64_t IndiceParticionado::ios() const {
+    uint64_t total = 0;
+    for (auto &arr : arboles) total += arr.reads + arr.writes;
+    return total;
+}
+
+/*
+nodos :: -> Int
+Cantidad total de nodos de todas las particiones.
+*/
+size_t IndiceParticionado::nodos() const {
+    size_t total = 0;
+    for (auto &arr : arboles) total += arr.nodes.size();
+    return total;
+}
+
+/*
+cortes_uniformes :: Int, Int, Int -> vector<Int>
+Divide [min_llave, max_llave] en k tramos de igual ancho y devuelve los k-1 cortes.
+*/
+vector<int> cortes_uniformes(int min_llave, int max_llave, int k) {
+    vector<int> cortes;
+    long long ancho = (long long)max_llave - min_llave + 1;
+    for (int i = 1; i < k; i++) cortes.push_back((int)(min_llave + ancho * i / k));
+    return cortes;
+}
+
+/*
+cortes_cuantiles :: vector<pair<Int,Float>>, Int -> vector<Int>
+Elige los k-1 cortes como cuantiles de una muestra de las llaves, para que cada particion reciba
+aproximadamente la misma cantidad de pares aunque la distribucion no sea uniforme.
+*/
+vector<int> cortes_cuantiles(const vector<pair<int,float>> &datos, int k) {
+    vector<int> cortes;
+    if (datos.empty() || k <= 1) return cortes;
+    const size_t Tam_muestra = 1 << 16;
+    size_t paso = max<size_t>(1, datos.size() / Tam_muestra);
+    vector<int> muestra;
+    for (size_t i = 0; i < datos.size(); i += paso) muestra.push_back(datos[i].first);
+    sort(muestra.begin(), muestra.end());
+    for (int i = 1; i < k; i++) cortes.push_back(muestra[muestra.size() * i / k]);
+    return cortes;
+}
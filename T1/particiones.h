@@ -0,0 +1,38 @@
+#ifndef PARTICIONES_H
+#define PARTICIONES_H
+
+#include "manejodisco.h"
+#include "btree.h"
+
+/*
+IndiceParticionado :: struct
+Indice que reparte el espacio de llaves entre K arboles B+ independientes, cada uno con su ListaNodo y su archivo.
+La particion i guarda las llaves en [cortes[i-1], cortes[i]) (la primera desde -inf y la ultima hasta +inf),
+asi que las particiones quedan ordenadas por llave y no se solapan.
+La insercion por lotes reparte los pares por particion y los inserta con un hilo por particion;
+una consulta de rango solo visita las particiones que solapan [l, u].
+*/
+struct IndiceParticionado {
+    std::vector<int> cortes;
+    std::vector<ListaNodo> arboles;
+    std::vector<int> raices;
+    std::vector<DiskManager> discos;
+    OpcionesArbol opciones;
+
+    IndiceParticionado(const std::vector<int> &cortes, const std::string &prefijo,
+                       const OpcionesArbol &opciones = OpcionesArbol());
+
+    int cantidad() const { return (int)arboles.size(); }
+    int particion_de(int llave) const;
+    void insertar(int llave, float valor);
+    void insertar_lote(const std::vector<std::pair<int,float>> &datos);
+    void write_all();
+    std::vector<std::pair<int,float>> range_search(int l, int u, int &io_busquedas);
+    uint64_t ios() const;
+    size_t nodos() const;
+};
+
+std::vector<int> cortes_uniformes(int min_llave, int max_llave, int k);
+std::vector<int> cortes_cuantiles(const std::vector<std::pair<int,float>> &datos, int k);
+
+#endif
@@ -0,0 +1,275 @@
+#include <bits/stdc++.h>
+#include "driver.h"
+#include "busqueda.h"
+#include "versiones.h"
+#include "borrado.h"
+#include "indicehash.h"
+#include "cacherango.h"
+using namespace std;
+
+/*
+verificar :: Bool, String -> Void
+Lanza runtime_error con el mensaje si la condicion no se cumple.
+*/
+static void verificar(bool condicion, const string &mensaje) {
+    if (!condicion) throw runtime_error(mensaje);
+}
+
+/*
+ordenados :: vector<pair<Int,Float>> -> vector<pair<Int,Float>>
+Ordena por llave y valor, para comparar resultados sin depender del orden de las llaves repetidas.
+*/
+static vector<pair<int,float>> ordenados(vector<pair<int,float>> pares) {
+    sort(pares.begin(), pares.end());
+    return pares;
+}
+
+/*
+lanza :: Funcion -> Bool
+Indica si la funcion lanza runtime_error.
+*/
+template <class F>
+static bool lanza(F f) {
+    try {
+        f();
+    } catch (const runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+/*
+prueba_versiones_reutiliza_paginas :: -> Void
+Arbol B+ con copy-on-write y agregados: se fija un snapshot, se sigue insertando, se suelta el snapshot (sus paginas
+quedan libres) y se inserta de nuevo, reutilizandolas. El snapshot y el arbol actual deben devolver sus propios pares
+bajando por el arbol, los agregados deben cuadrar despues de cada flush, y las busquedas que siguen la cadena de hojas
+deben lanzar runtime_error en vez de leer paginas reutilizadas.
+*/
+static void prueba_versiones_reutiliza_paginas() {
+    const string archivo = "prueba_versiones.bin";
+    remove(archivo.c_str());
+    remove((archivo + ".agg").c_str());
+
+    ListaNodo arr;
+    VersionesArbol versiones;
+    Agregados agregados;
+    OpcionesArbol opciones;
+    opciones.versiones = &versiones;
+    opciones.agregados = &agregados;
+    DiskManager dm(archivo);
+
+    mt19937 rng(31);
+    vector<pair<int,float>> esperado;
+    auto insertar_lote = [&](int &raiz, int cantidad) {
+        for (int i = 0; i < cantidad; ++i) {
+            pair<int,float> par((int)(rng() % 1000000), (float)esperado.size());
+            insert(arr, raiz, par.first, par.second, true, opciones);
+            esperado.push_back(par);
+        }
+        versiones.flush(dm, arr, raiz, &agregados);
+    };
+    auto verificar_actual = [&](int raiz, const string &etapa) {
+        int io = 0;
+        auto res = range_search_tree_disk(dm, raiz, numeric_limits<int>::min(), numeric_limits<int>::max(), io);
+        verificar(ordenados(res) == ordenados(esperado), etapa + ": el arbol actual no devuelve sus pares");
+        Resumen resumen = range_aggregate_Bplus_disk(dm, raiz, numeric_limits<int>::min(), numeric_limits<int>::max(), io);
+        double suma = 0.0;
+        for (auto &p : esperado) suma += p.second;
+        verificar(resumen.cantidad == esperado.size() && fabs(resumen.suma - suma) <= 1e-6 * suma,
+                  etapa + ": los agregados no cuadran con el arbol actual");
+    };
+
+    int raiz = construir_arbol(arr, {}, true, opciones);
+    insertar_lote(raiz, 20000);
+    verificar_actual(raiz, "antes del snapshot");
+
+    uint32_t snapshot = versiones.tomar_snapshot(raiz);
+    vector<pair<int,float>> esperado_snapshot = esperado;
+    insertar_lote(raiz, 20000);
+    verificar_actual(raiz, "con el snapshot fijado");
+    int io = 0;
+    auto res = range_search_tree_disk(dm, versiones.raiz_de(snapshot), numeric_limits<int>::min(),
+                                      numeric_limits<int>::max(), io);
+    verificar(ordenados(res) == ordenados(esperado_snapshot), "el snapshot cambio con las inserciones posteriores");
+
+    versiones.liberar_snapshot(snapshot, arr);
+    size_t libres = arr.libres.size();
+    verificar(libres > 0, "liberar el snapshot no libero paginas");
+    insertar_lote(raiz, 20000);
+    verificar(arr.libres.size() < libres, "las inserciones no reutilizaron las paginas liberadas");
+    verificar_actual(raiz, "despues de reutilizar paginas");
+
+    verificar(lanza([&] { range_search_Bplus_disk(dm, raiz, 0, 1000000, io); }),
+              "range_search_Bplus_disk siguio la cadena de hojas de un arbol con copy-on-write");
+    verificar(lanza([&] { last_n_Bplus_disk(dm, raiz, 1000000, 10, io); }),
+              "last_n_Bplus_disk siguio la cadena de hojas de un arbol con copy-on-write");
+
+    remove(archivo.c_str());
+    remove((archivo + ".agg").c_str());
+}
+
+/*
+prueba_busqueda_paralela :: -> Void
+Arbol B en disco: range_search_B_disk_paralelo debe devolver los mismos pares y leer los mismos nodos que
+range_search_B_disk. Una lectura fuera del archivo debe lanzar runtime_error, y la cola de lecturas debe seguir
+sirviendo despues del fallo.
+*/
+static void prueba_busqueda_paralela() {
+    const string archivo = "prueba_paralela.bin";
+    mt19937 rng(39);
+    vector<pair<int,float>> datos;
+    for (int i = 0; i < 50000; ++i) datos.emplace_back((int)(rng() % 200000), (float)i);
+    ListaNodo arr;
+    int raiz = construir_arbol(arr, datos, false);
+    DiskManager dm(archivo);
+    dm.fijar_raiz(raiz, false);
+    dm.write_all(arr);
+
+    auto comparar = [&](int l, int u) {
+        vector<pair<int,float>> secuencial, paralelo;
+        int io_secuencial = 0, io_paralelo = 0;
+        range_search_B_disk(dm, raiz, l, u, secuencial, io_secuencial);
+        range_search_B_disk_paralelo(dm, raiz, l, u, paralelo, io_paralelo, 4);
+        verificar(ordenados(secuencial) == ordenados(paralelo),
+                  "la busqueda paralela no devuelve los pares de [" + to_string(l) + ", " + to_string(u) + "]");
+        verificar(io_secuencial == io_paralelo, "la busqueda paralela no lee los mismos nodos");
+    };
+    for (int q = 0; q < 50; ++q) {
+        int l = (int)(rng() % 200000);
+        comparar(l, l + (int)(rng() % 20000));
+    }
+    comparar(numeric_limits<int>::min(), numeric_limits<int>::max());
+
+    verificar(lanza([&] { dm.read_nodes({0, arr.size() + 10, 1}, 4); }),
+              "read_nodes devolvio un nodo fuera del archivo sin lanzar");
+    comparar(1000, 5000);
+
+    remove(archivo.c_str());
+}
+
+/*
+prueba_hash_llaves_repetidas :: -> Void
+Arbol B+ con copy-on-write e indice hash sobre pocas llaves muy repetidas, cuyas apariciones quedan repartidas en
+varias hojas al dividirse. Se insertan y borran llaves al azar fijando un snapshot por ronda: copiar una hoja que solo
+tiene lapidas de una llave reindexa la llave a esa copia aunque siga viva en otra hoja.
+get y get_disk deben encontrar toda llave viva y ninguna borrada.
+*/
+static void prueba_hash_llaves_repetidas() {
+    const string archivo = "prueba_hash.bin";
+    const int llaves = 1000;
+    ListaNodo arr;
+    IndiceHash indice;
+    VersionesArbol versiones;
+    OpcionesArbol opciones;
+    opciones.hash = &indice;
+    opciones.versiones = &versiones;
+
+    int raiz = construir_arbol(arr, {}, true, opciones);
+    mt19937 rng(0);
+    vector<int> vivas(llaves, 0);
+    for (int ronda = 0; ronda < 20; ++ronda) {
+        versiones.tomar_snapshot(raiz);
+        for (int i = 0; i < 3000; ++i) {
+            int llave = (int)(rng() % llaves);
+            insert(arr, raiz, llave, (float)i, true, opciones);
+            vivas[llave]++;
+        }
+        for (int i = 0; i < llaves / 15; ++i) {
+            int llave = (int)(rng() % llaves);
+            erase(arr, raiz, llave, true, opciones);
+            vivas[llave] = 0;
+        }
+        for (int llave = 0; llave < llaves; ++llave) {
+            float valor = 0.0f;
+            verificar(get(arr, indice, raiz, llave, valor) == (vivas[llave] > 0),
+                      "ronda " + to_string(ronda) + ": get no coincide para la llave " + to_string(llave));
+        }
+    }
+
+    DiskManager dm(archivo);
+    dm.fijar_raiz(raiz, true);
+    dm.write_all(arr);
+    for (int llave = 0; llave < llaves; ++llave) {
+        float valor = 0.0f;
+        int io = 0;
+        verificar(get_disk(dm, indice, raiz, llave, valor, io) == (vivas[llave] > 0),
+                  "get_disk no coincide para la llave " + to_string(llave));
+    }
+    remove(archivo.c_str());
+}
+
+/*
+prueba_cache_rangos_lru :: -> Void
+Cache de rangos chica sobre un arbol B+ en disco: con consultas, ventanas que se deslizan e invalidaciones al azar,
+cada consulta debe devolver lo mismo que sin cache, la lista lru debe tener exactamente un inicio por tramo (y cada
+tramo apuntar al suyo), y la cache no debe pasarse de su capacidad. Despues de un uso, el tramo debe quedar al frente.
+*/
+static void prueba_cache_rangos_lru() {
+    const string archivo = "prueba_cache.bin";
+    mt19937 rng(43);
+    vector<pair<int,float>> datos;
+    for (int i = 0; i < 30000; ++i) datos.emplace_back((int)(rng() % 300000), (float)i);
+    ListaNodo arr;
+    int raiz = construir_arbol(arr, datos, true);
+    DiskManager dm(archivo);
+    dm.fijar_raiz(raiz, true);
+    dm.write_all(arr);
+
+    CacheRangos cache(2000);
+    auto verificar_cache = [&](const string &etapa) {
+        verificar(cache.lru.size() == cache.tramos.size(), etapa + ": lru no tiene un inicio por tramo");
+        size_t pares = 0;
+        for (auto it = cache.tramos.begin(); it != cache.tramos.end(); ++it) {
+            verificar(*it->second.en_lru == it->first, etapa + ": un tramo no apunta a su inicio en lru");
+            pares += it->second.pares.size();
+        }
+        verificar(pares == cache.pares_guardados && pares <= cache.capacidad_pares,
+                  etapa + ": la cuenta de pares no cuadra o se paso de la capacidad");
+    };
+
+    int ventana = 0;
+    for (int q = 0; q < 400; ++q) {
+        int l = (q % 3 == 0) ? (ventana += 500) : (int)(rng() % 300000);
+        int u = l + 2000;
+        int io = 0;
+        auto esperado = range_search_Bplus_disk(dm, raiz, l, u, io);
+        auto res = range_search_Bplus_disk(dm, raiz, cache, l, u, io);
+        verificar(res == esperado, "consulta " + to_string(q) + ": la cache cambio el resultado");
+        verificar_cache("consulta " + to_string(q));
+        if (q % 7 == 0) {
+            int a = (int)(rng() % 300000);
+            cache.invalidar(a, a + (int)(rng() % 3000));
+            verificar_cache("invalidacion " + to_string(q));
+        }
+    }
+
+    int io = 0;
+    range_search_Bplus_disk(dm, raiz, cache, 100000, 100500, io);
+    auto it = prev(cache.tramos.upper_bound(100000));
+    verificar(it->first <= 100000 && it->second.u >= 100500 && cache.lru.front() == it->first,
+              "el tramo usado no quedo al frente de lru");
+    remove(archivo.c_str());
+}
+
+/*
+Corre todas las pruebas e informa cuales fallaron. Termina con codigo 1 si alguna fallo.
+*/
+int main() {
+    vector<pair<string, void (*)()>> pruebas = {
+        {"versiones_reutiliza_paginas", prueba_versiones_reutiliza_paginas},
+        {"busqueda_paralela", prueba_busqueda_paralela},
+        {"hash_llaves_repetidas", prueba_hash_llaves_repetidas},
+        {"cache_rangos_lru", prueba_cache_rangos_lru},
+    };
+    int fallidas = 0;
+    for (auto &prueba : pruebas) {
+        try {
+            prueba.second();
+            cout << "[ok] " << prueba.first << "\n";
+        } catch (const exception &e) {
+            cout << "[falla] " << prueba.first << ": " << e.what() << "\n";
+            fallidas++;
+        }
+    }
+    return fallidas == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "versiones.h"
+#include <stdexcept>
+using namespace std;
+
+/*
+registrar :: Int -> Void
+Anota que el nodo idx se creo (o se reutilizo) en la epoca actual y que hay que llevarlo a disco en el proximo flush.
+*/
+void VersionesArbol::registrar(int idx) {
+    if (idx >= (int)epoca_nodo.size()) epoca_nodo.resize(idx + 1, 0);
+    epoca_nodo[idx] = epoca;
+    marcar_sucia(idx);
+}
+
+/*
+marcar_sucia :: Int -> Void
+Agrega idx a las paginas pendientes de flush, sin repetirla.
+*/
+void VersionesArbol::marcar_sucia(int idx) {
+    if (idx >= (int)es_sucia.size()) es_sucia.resize(idx + 1, false);
+    if (es_sucia[idx]) return;
+    es_sucia[idx] = true;
+    sucias.push_back(idx);
+}
+
+/*
+compartido :: Int -> Bool
+Un nodo creado en la epoca c puede estar en cualquier snapshot tomado en una epoca s >= c.
+Basta mirar el snapshot fijado mas reciente.
+*/
+bool VersionesArbol::compartido(int idx) const {
+    if (snapshots.empty()) return false;
+    uint32_t creado = (idx < (int)epoca_nodo.size()) ? epoca_nodo[idx] : epoca;
+    return snapshots.rbegin()->first >= creado;
+}
+
+/*
+escribible :: ListaNodo, Int, Nodo -> Int
+Devuelve una posicion donde se puede escribir el nodo idx sin alterar ningun snapshot.
+Si el nodo no esta compartido es la misma posicion; si no, se agrega una copia con el contenido dado y la pagina
+original queda retirada. El llamador debe actualizar el puntero del padre cuando la posicion cambia.
+*/
+int VersionesArbol::escribible(ListaNodo &arr, int idx, const Nodo &contenido) {
+    if (!compartido(idx)) {
+        marcar_sucia(idx);
+        return idx;
+    }
+    uint32_t creado = (idx < (int)epoca_nodo.size()) ? epoca_nodo[idx] : epoca;
+    retiradas.push_back({idx, creado, epoca});
+    int copia = arr.append(contenido);
+    registrar(copia);
+    return copia;
+}
+
+/*
+tomar_snapshot :: Int -> UInt32
+Fija la raiz dada como una version de solo lectura y devuelve su identificador.
+Los lectores deben usar una raiz fijada solo despues de un flush, para que todas sus paginas esten en disco.
+*/
+uint32_t VersionesArbol::tomar_snapshot(int raiz) {
+    uint32_t id = epoca;
+    auto it = snapshots.find(id);
+    if (it != snapshots.end()) it->second.second++;
+    else snapshots[id] = {raiz, 1};
+    epoca++;
+    return id;
+}
+
+/*
+raiz_de :: UInt32 -> Int
+Raiz del snapshot fijado.
+*/
+int VersionesArbol::raiz_de(uint32_t snapshot) const {
+    auto it = snapshots.find(snapshot);
+    if (it == snapshots.end()) throw runtime_error("VersionesArbol::raiz_de: snapshot inexistente");
+    return it->second.first;
+}
+
+/*
+liberar_snapshot :: UInt32, ListaNodo -> Void
+Suelta un lector del snapshot; cuando no quedan lectores se recolectan las paginas que solo el usaba.
+*/
+void VersionesArbol::liberar_snapshot(uint32_t snapshot, ListaNodo &arr) {
+    auto it = snapshots.find(snapshot);
+    if (it == snapshots.end()) return;
+    if (--it->second.second == 0) snapshots.erase(it);
+    recolectar(arr);
+}
+
+/*
+recolectar :: ListaNodo -> Void
+Libera en la ListaNodo las paginas retiradas que ningun snapshot fijado alcanza,
+es decir, las que no tienen un snapshot fijado con epoca en [creada, retirada).
+*/
+void VersionesArbol::recolectar(ListaNodo &arr) {
+    size_t j = 0;
+    for (size_t i = 0; i < retiradas.size(); ++i) {
+        const PaginaRetirada &p = retiradas[i];
+        auto it = snapshots.lower_bound(p.creada);
+        bool en_uso = it != snapshots.end() && it->first < p.retirada;
+        if (en_uso) retiradas[j++] = p;
+        else arr.liberar(p.idx);
+    }
+    retiradas.resize(j);
+}
+
+/*
+flush :: DiskManager, ListaNodo, Int, Agregados* -> Void
+Escribe en disco solo las paginas nuevas o modificadas desde el ultimo flush.
+Nunca sobrescribe una pagina de un snapshot fijado, asi que los lectores de ese snapshot no se bloquean ni ven cambios.
+Si se entrega la raiz actual, queda en el superbloque (que se escribe despues de las paginas).
+Si el arbol lleva agregados, los nodos internos escritos reciben bloques de resumen nuevos (ver DiskManager::write_pages).
+El superbloque queda marcado sin cadena de hojas, porque con copy-on-write los enlaces entre hojas no se mantienen.
+*/
+void VersionesArbol::flush(DiskManager &dm, const ListaNodo &arr, int raiz, const Agregados *agregados) {
+    if (raiz >= 0) dm.cabecera.raiz = raiz;
+    dm.cabecera.hojas_enlazadas = 0;
+    sort(sucias.begin(), sucias.end());
+    dm.write_pages(arr, sucias, agregados);
+    for (int idx : sucias) es_sucia[idx] = false;
+    sucias.clear();
+}
@@ -0,0 +1,48 @@
+#ifndef VERSIONES_H
+#define VERSIONES_H
+
+#include "listanodo.h"
+#include "manejodisco.h"
+
+/*
+VersionesArbol :: struct
+Copy-on-write sobre una ListaNodo para poder consultar versiones fijas del arbol mientras se sigue insertando.
+Cada nodo guarda la epoca en que fue creado. Tomar un snapshot fija la raiz actual y avanza la epoca;
+desde ese momento un nodo que pueda pertenecer a un snapshot fijado no se modifica en su lugar, sino que se copia
+a una posicion nueva (y los ancestros se copian tambien, porque cambia el puntero al hijo).
+Las paginas reemplazadas se liberan cuando ningun snapshot fijado las alcanza.
+Solo la insercion respeta copy-on-write: erase y compact modifican en su lugar y no deben usarse con snapshots fijados.
+Los enlaces siguiente y anterior entre hojas no se mantienen (mantenerlos obligaria a copiar la cadena de hojas entera),
+asi que un arbol con copy-on-write se consulta bajando por el arbol (range_search_tree_disk, range_aggregate_Bplus_disk).
+*/
+struct VersionesArbol {
+    /*
+    PaginaRetirada :: struct
+    Pagina que dejo de pertenecer al arbol actual: fue creada en la epoca `creada` y reemplazada en la epoca `retirada`.
+    */
+    struct PaginaRetirada {
+        int idx;
+        uint32_t creada;
+        uint32_t retirada;
+    };
+
+    uint32_t epoca = 0;
+    std::vector<uint32_t> epoca_nodo;
+    std::map<uint32_t, std::pair<int,int>> snapshots;   // epoca del snapshot -> (raiz, cantidad de lectores)
+    std::vector<PaginaRetirada> retiradas;
+    std::vector<int> sucias;                            // paginas escritas desde el ultimo flush
+    std::vector<bool> es_sucia;
+
+    void registrar(int idx);
+    void marcar_sucia(int idx);
+    bool compartido(int idx) const;
+    int escribible(ListaNodo &arr, int idx, const Nodo &contenido);
+
+    uint32_t tomar_snapshot(int raiz);
+    int raiz_de(uint32_t snapshot) const;
+    void liberar_snapshot(uint32_t snapshot, ListaNodo &arr);
+    void recolectar(ListaNodo &arr);
+    void flush(DiskManager &dm, const ListaNodo &arr, int raiz = -1, const Agregados *agregados = nullptr);
+};
+
+#endif
@@ -0,0 +1,327 @@
+#include <algorithm>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+#include "frozen_trie.h"
+#include "trie.h"
+
+using namespace std;
+
+/**
+ * Posición del uno número r (desde 0) dentro de una palabra
+ * Con BMI2 es un solo pdep; si no, salta de a bytes con popcount y termina dentro del byte.
+ * @param x: palabra
+ * @param r: número del uno (menor que la cantidad de unos de x)
+ * @return: su posición en la palabra
+ */
+static inline uint32_t select_in_word(uint64_t x, uint32_t r) {
+#if defined(__BMI2__)
+    return __builtin_ctzll(_pdep_u64(1ULL << r, x));
+#else
+    uint32_t shift = 0;
+    for (;;) {
+        uint32_t c = __builtin_popcount((uint32_t)(x & 0xFF));
+        if (r < c) break;
+        r -= c;
+        x >>= 8;
+        shift += 8;
+    }
+    for (; r > 0; r--) x &= x - 1;
+    return shift + __builtin_ctzll(x);
+#endif
+}
+
+/**
+ * Arma los directorios de rank y select
+ * ranks[w] son los unos antes de la palabra w; samples1[j] (samples0[j]) es la palabra donde está el uno (cero)
+ * número j * MUESTRA.
+ */
+void BitVector::build() {
+    ranks.assign(bits.size() + 1, 0);
+    samples1.clear();
+    samples0.clear();
+
+    uint32_t unos = 0;
+    for (size_t w = 0; w < bits.size(); w++) {
+        ranks[w] = unos;
+        uint32_t c = __builtin_popcountll(bits[w]);
+        uint32_t validos = (uint32_t)min<uint64_t>(64, n - w * 64);
+        uint32_t ceros_antes = (uint32_t)(w * 64) - unos;
+        while ((uint64_t)samples1.size() * MUESTRA < unos + c) samples1.push_back((uint32_t)w);
+        while ((uint64_t)samples0.size() * MUESTRA < ceros_antes + validos - c) samples0.push_back((uint32_t)w);
+        unos += c;
+    }
+    ranks[bits.size()] = unos;
+}
+
+/**
+ * Posición del uno número k (desde 0)
+ * Parte de la muestra anterior, avanza por palabras con ranks y termina dentro de la palabra.
+ * @param k: número del uno
+ * @return: su posición
+ */
+uint64_t BitVector::select1(uint32_t k) const {
+    uint32_t w = samples1[k / MUESTRA];
+    while (ranks[w + 1] <= k) w++;
+    return ((uint64_t)w << 6) + select_in_word(bits[w], k - ranks[w]);
+}
+
+/**
+ * Posición del cero número k (desde 0)
+ * @param k: número del cero
+ * @return: su posición
+ */
+uint64_t BitVector::select0(uint32_t k) const {
+    uint32_t w = samples0[k / MUESTRA];
+    while ((uint64_t)(w + 1) * 64 - ranks[w + 1] <= k) w++;
+    return ((uint64_t)w << 6) + select_in_word(~bits[w], k - (uint32_t)((uint64_t)w * 64 - ranks[w]));
+}
+
+size_t BitVector::bytes() const {
+    return bits.capacity() * sizeof(uint64_t) +
+           (ranks.capacity() + samples1.capacity() + samples0.capacity()) * sizeof(uint32_t);
+}
+
+/**
+ * Convierte el trie en su representación estática
+ * Recorre los nodos por niveles con los hijos en orden de byte, que es el orden en que quedan numerados, y
+ * traduce best_terminal y las listas de candidatos (nodos) a números de palabra.
+ * @return: el trie congelado
+ */
+FrozenTrie Trie::freeze() {
+    FrozenTrie f;
+    vector<uint32_t> order; // Nodos del trie en el orden del trie congelado
+    order.reserve(nodes.size());
+
+    order.push_back(0);
+    f.keys.push_back(0);
+    f.louds.push_back(1);
+    f.louds.push_back(0);
+    for (size_t i = 0; i < order.size(); i++) {
+        for_each_child(nodes[order[i]], [&](uint8_t key, uint32_t child) {
+            order.push_back(child);
+            f.keys.push_back(key);
+            f.louds.push_back(1);
+        });
+        f.louds.push_back(0);
+    }
+
+    vector<uint32_t> word_of(nodes.cantidad, NULO); // Número de la palabra de cada nodo terminal
+    for (uint32_t v : order) {
+        const TrieNode& n = nodes[v];
+        f.label_bits.push_back(1);
+        for (uint32_t j = 1; j < n.label_len; j++) {
+            f.labels.push_back((char)label_at(n, j));
+            f.label_bits.push_back(0);
+        }
+        f.terminal.push_back(n.word != NULO);
+        if (n.word != NULO) {
+            word_of[v] = (uint32_t)f.priority.size();
+            f.word_offsets.push_back((uint32_t)f.word_chars.size());
+            f.word_chars += words[n.word];
+            f.priority.push_back(n.priority);
+        }
+    }
+    f.label_bits.push_back(1);
+    f.word_offsets.push_back((uint32_t)f.word_chars.size());
+
+    f.best.reserve(order.size());
+    for (uint32_t v : order) {
+        uint32_t b = nodes[v].best_terminal;
+        f.best.push_back(b == NULO ? NULO : word_of[b]);
+    }
+
+    if (top_k > 1) {
+        f.top_k = top_k;
+        f.top.reserve(order.size() * top_k);
+        for (uint32_t v : order) {
+            for (int i = 0; i < top_k; i++) {
+                uint32_t t = top[(size_t)v * top_k + i];
+                f.top.push_back(t == NULO ? NULO : word_of[t]);
+            }
+        }
+    }
+
+    f.louds.build();
+    f.label_bits.build();
+    f.terminal.build();
+    f.keys.shrink_to_fit();
+    f.labels.shrink_to_fit();
+    f.word_chars.shrink_to_fit();
+    f.word_offsets.shrink_to_fit();
+    f.priority.shrink_to_fit();
+    f.node_count = (uint32_t)order.size();
+    f.access_counter = access_counter;
+    return f;
+}
+
+/**
+ * Avanza un carácter desde una posición
+ * Si queda etiqueta por recorrer compara con su siguiente carácter. Si no, los hijos de v son los nodos
+ * [select0(v) - v, select0(v + 1) - v - 1) y se busca entre ellos el que empieza con el carácter. El segundo
+ * select0 es el primer cero después del primero, así que se busca avanzando por la palabra.
+ * @param p: posición actual
+ * @param c: carácter por el que descender
+ * @return: la nueva posición (con node en NULO si el prefijo no está en el trie)
+ */
+FrozenCursor FrozenTrie::descend(FrozenCursor p, char c) const {
+    const FrozenCursor fuera{NULO, 0, 0};
+    if (p.node == NULO) return fuera;
+    uint8_t key = Trie::char_to_index(c);
+
+    if (p.pos < p.end) {
+        if ((uint8_t)labels[p.pos] != key) return fuera;
+        p.pos++;
+        return p;
+    }
+
+    uint64_t z = louds.select0(p.node);
+    uint32_t first = (uint32_t)(z - p.node);
+    uint32_t last = (uint32_t)(louds.next0(z + 1) - p.node - 1);
+    auto it = lower_bound(keys.begin() + first, keys.begin() + last, key);
+    if (it == keys.begin() + last || *it != key) return fuera;
+
+    uint32_t child = (uint32_t)(it - keys.begin());
+    uint64_t s = label_bits.select1(child);
+    p.node = child;
+    p.pos = (uint32_t)(s - child);
+    p.end = p.pos + (uint32_t)(label_bits.next1(s + 1) - s - 1);
+    return p;
+}
+
+/**
+ * Retorna los k mejores autocompletados de una posición
+ * Sin listas (top_k = 1) retorna a lo más best.
+ * @param p: posición
+ * @param k: cantidad de sugerencias (se usan a lo más top_k)
+ * @return: números de las palabras de mayor a menor prioridad
+ */
+vector<uint32_t> FrozenTrie::autocomplete_k(FrozenCursor p, int k) const {
+    vector<uint32_t> result;
+    if (p.node == NULO || k <= 0) return result;
+    if (top_k == 1) {
+        if (best[p.node] != NULO) result.push_back(best[p.node]);
+        return result;
+    }
+
+    const uint32_t* lista = &top[(size_t)p.node * top_k];
+    for (int i = 0; i < min(k, top_k) && lista[i] != NULO; i++) result.push_back(lista[i]);
+    return result;
+}
+
+/**
+ * Busca una palabra
+ * @param w: palabra
+ * @return: su número (el rank de su nodo en terminal) o NULO si no está en el trie
+ */
+uint32_t FrozenTrie::get_terminal(const string& w) const {
+    FrozenCursor current = start();
+    for (char c : w) {
+        current = descend(current, c);
+        if (current.node == NULO) return NULO;
+    }
+    return current.at_node() && terminal[current.node] ? terminal.rank1(current.node) : NULO;
+}
+
+/**
+ * Actualiza prioridad según variante de frecuencia
+ * Incrementa la prioridad en 1 y propaga cambios hacia la raíz
+ * @param word: número de la palabra
+ */
+void FrozenTrie::update_priority_frequency(uint32_t word) {
+    if (word == NULO) return;
+    priority[word]++;
+    propagate_increase(word);
+}
+
+/**
+ * Actualiza prioridad según variante de reciente
+ * Asigna un timestamp basado en access_counter y propaga cambios
+ * @param word: número de la palabra
+ */
+void FrozenTrie::update_priority_recent(uint32_t word) {
+    if (word == NULO) return;
+    priority[word] = ++access_counter;
+    propagate_increase(word);
+}
+
+/**
+ * Orden de dos palabras con la misma prioridad (ver Trie::tie_before)
+ * @param a: número de palabra
+ * @param b: número de palabra
+ * @return: true si a va antes que b
+ */
+bool FrozenTrie::tie_before(uint32_t a, uint32_t b) const {
+    string_view wa = get_word(a);
+    string_view wb = get_word(b);
+    size_t i = 0;
+    while (i < wa.size() && i < wb.size() && Trie::char_to_index(wa[i]) == Trie::char_to_index(wb[i])) i++;
+    if (i == wa.size()) return false;
+    if (i == wb.size()) return true;
+    return Trie::char_to_index(wa[i]) < Trie::char_to_index(wb[i]);
+}
+
+/**
+ * Sube una palabra en la lista de candidatos de un nodo (ver Trie::raise_in_top)
+ * @param v: nodo
+ * @param updated: número de la palabra
+ * @return: true si la lista cambió o contiene a updated
+ */
+bool FrozenTrie::raise_in_top(uint32_t v, uint32_t updated) {
+    uint32_t* lista = &top[(size_t)v * top_k];
+    long long p = priority[updated];
+
+    // Se saca updated si estaba
+    int n = 0;
+    for (int i = 0; i < top_k && lista[i] != NULO; i++) {
+        if (lista[i] != updated) lista[n++] = lista[i];
+    }
+
+    int i = n;
+    while (i > 0 && (priority[lista[i - 1]] < p ||
+                     (priority[lista[i - 1]] == p && tie_before(updated, lista[i - 1])))) {
+        i--;
+    }
+    if (i == top_k) return false; // La lista está llena y updated no le gana a ninguno
+
+    for (int j = min(n, top_k - 1); j > i; j--) lista[j] = lista[j - 1];
+    lista[i] = updated;
+    return true;
+}
+
+/**
+ * Propaga hacia la raíz un aumento de prioridad
+ * Como en Trie::propagate_increase, en cada ancestro se compara solo con su mejor palabra. Las prioridades se leen
+ * de priority, así que un ancestro cuyo mejor ya era la palabra no cambia, pero hay que seguir subiendo.
+ * @param word: número de la palabra
+ */
+void FrozenTrie::propagate_increase(uint32_t word) {
+    uint32_t v = (uint32_t)terminal.select1(word);
+    long long p = priority[word];
+
+    for (;;) {
+        uint32_t b = best[v];
+        bool changed = false;
+        if (b == word) {
+            changed = true;
+        } else if (b == NULO || p > priority[b] || (p == priority[b] && tie_before(word, b))) {
+            best[v] = word;
+            changed = true;
+        }
+        if (top_k > 1 && raise_in_top(v, word)) changed = true;
+
+        // Si perdió contra el mejor de este ancestro, los de arriba tampoco cambian
+        if (!changed || v == 0) break;
+        v = (uint32_t)(louds.select1(v) - v) - 1;
+    }
+}
+
+/**
+ * Obtiene la memoria reservada por el trie congelado
+ * @return: cantidad de bytes
+ */
+size_t FrozenTrie::get_memory_bytes() const {
+    return louds.bytes() + label_bits.bytes() + terminal.bytes() + keys.capacity() + labels.capacity() +
+           word_chars.capacity() + word_offsets.capacity() * sizeof(uint32_t) +
+           priority.capacity() * sizeof(long long) + (best.capacity() + top.capacity()) * sizeof(uint32_t);
+}
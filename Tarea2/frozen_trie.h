@@ -0,0 +1,245 @@
+#ifndef FROZEN_TRIE_H
+#define FROZEN_TRIE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "slab.h"
+
+using namespace std;
+
+/**
+ * Vector de bits con rank y select
+ * Guarda los bits en palabras de 64, la cantidad de unos antes de cada palabra, y cada MUESTRA-ésimo uno y cero
+ * para empezar la búsqueda de select cerca de la respuesta.
+ * Se llena con push_back y se prepara con build() antes de consultar.
+ */
+struct BitVector {
+    static const uint32_t MUESTRA = 64;
+
+    vector<uint64_t> bits;
+    vector<uint32_t> ranks;     // Unos antes de cada palabra (una entrada extra al final con el total)
+    vector<uint32_t> samples1;  // Palabra donde está el uno número j * MUESTRA
+    vector<uint32_t> samples0;  // Palabra donde está el cero número j * MUESTRA
+    uint64_t n = 0;
+
+    /**
+     * Agrega un bit al final
+     * @param b: valor del bit
+     */
+    void push_back(bool b) {
+        if ((n & 63) == 0) bits.push_back(0);
+        if (b) bits.back() |= 1ULL << (n & 63);
+        n++;
+    }
+
+    bool operator[](uint64_t i) const { return (bits[i >> 6] >> (i & 63)) & 1; }
+
+    /**
+     * Arma los directorios de rank y select
+     */
+    void build();
+
+    /**
+     * Cantidad de unos en [0, i)
+     * @param i: posición
+     * @return: cantidad de unos
+     */
+    uint32_t rank1(uint64_t i) const {
+        uint32_t r = ranks[i >> 6];
+        if (i & 63) r += __builtin_popcountll(bits[i >> 6] & ((1ULL << (i & 63)) - 1));
+        return r;
+    }
+
+    /**
+     * Cantidad de ceros en [0, i)
+     * @param i: posición
+     * @return: cantidad de ceros
+     */
+    uint32_t rank0(uint64_t i) const { return (uint32_t)(i - rank1(i)); }
+
+    /**
+     * Posición del uno número k (desde 0)
+     * @param k: número del uno
+     * @return: su posición
+     */
+    uint64_t select1(uint32_t k) const;
+
+    /**
+     * Posición del cero número k (desde 0)
+     * @param k: número del cero
+     * @return: su posición
+     */
+    uint64_t select0(uint32_t k) const;
+
+    /**
+     * Posición del primer uno en [i, n), o n si no hay
+     * @param i: posición desde donde buscar
+     * @return: su posición
+     */
+    uint64_t next1(uint64_t i) const {
+        uint64_t w = i >> 6;
+        uint64_t x = bits[w] & (~0ULL << (i & 63));
+        while (x == 0 && ++w < bits.size()) x = bits[w];
+        return x == 0 ? n : min(n, (w << 6) + __builtin_ctzll(x));
+    }
+
+    /**
+     * Posición del primer cero en [i, n), o n si no hay
+     * @param i: posición desde donde buscar
+     * @return: su posición
+     */
+    uint64_t next0(uint64_t i) const {
+        uint64_t w = i >> 6;
+        uint64_t x = ~bits[w] & (~0ULL << (i & 63));
+        while (x == 0 && ++w < bits.size()) x = ~bits[w];
+        return x == 0 ? n : min(n, (w << 6) + __builtin_ctzll(x));
+    }
+
+    /**
+     * Bytes reservados por los bits y los directorios
+     * @return: cantidad de bytes
+     */
+    size_t bytes() const;
+};
+
+/**
+ * Posición en el trie congelado después de escribir un prefijo
+ * node es el nodo al que lleva la arista actual (NULO si el prefijo no está) y [pos, end) lo que queda de su
+ * etiqueta en FrozenTrie::labels.
+ */
+struct FrozenCursor {
+    uint32_t node;
+    uint32_t pos;
+    uint32_t end;
+
+    /**
+     * Verifica si la posición está justo en node (y no a mitad de su arista)
+     * @return: true si se recorrió toda la etiqueta
+     */
+    bool at_node() const { return node != NULO && pos == end; }
+};
+
+/**
+ * Trie congelado para servir autocompletado después de construir el diccionario
+ * Es una copia estática de un Trie (ver Trie::freeze) donde la forma del árbol ya no cambia; solo cambian las
+ * prioridades. Los nodos se numeran por niveles (BFS) y los hijos de cada nodo quedan consecutivos y en orden
+ * de byte, así que la forma se guarda como LOUDS: por cada nodo, un uno por hijo y un cero.
+ * - keys[v] es el primer byte de la arista que llega a v; bajar a un hijo es una búsqueda binaria entre hermanos.
+ * - El resto de la etiqueta está en labels; label_bits tiene, por nodo, un uno seguido de un cero por carácter.
+ * - terminal marca los nodos donde termina una palabra; su rank es el número de la palabra.
+ * - priority (por palabra) y best (por nodo, el número de la mejor palabra del subárbol) son arreglos planos que
+ *   se actualizan en su lugar, igual que top, las listas de candidatos si el Trie tenía top_k > 1.
+ * Las palabras se identifican por su número (NULO si no hay palabra) en lugar de por un puntero a su nodo.
+ */
+struct FrozenTrie {
+    BitVector louds;            // "10" de una súper raíz y luego, por nodo en BFS, un uno por hijo y un cero
+    vector<uint8_t> keys;       // Primer byte de la arista que llega a cada nodo (0 en la raíz)
+    BitVector label_bits;       // Largo del resto de la etiqueta de cada nodo, en unario
+    string labels;              // Resto de las etiquetas (sin el primer byte), en minúscula
+    BitVector terminal;         // Si una palabra termina en cada nodo
+    string word_chars;          // Palabras tal como se insertaron, una tras otra
+    vector<uint32_t> word_offsets; // Inicio de cada palabra en word_chars (una entrada extra al final)
+    vector<long long> priority; // Prioridad de cada palabra
+    vector<uint32_t> best;      // Mejor palabra del subárbol de cada nodo (NULO si no hay)
+    int top_k = 1;              // Largo de las listas de candidatos (1: solo best)
+    vector<uint32_t> top;       // Con top_k > 1, top_k palabras por nodo (top[v * top_k + i], NULO al final)
+    uint32_t node_count = 0;
+    long long access_counter = 0;
+
+    /**
+     * Posición de la raíz (el prefijo vacío)
+     * @return: cursor en la raíz
+     */
+    FrozenCursor start() const { return FrozenCursor{0, 0, 0}; }
+
+    /**
+     * Avanza un carácter desde una posición, dentro de la arista actual o hacia un hijo
+     * @param p: posición actual
+     * @param c: carácter por el que descender
+     * @return: la nueva posición (con node en NULO si el prefijo no está en el trie)
+     */
+    FrozenCursor descend(FrozenCursor p, char c) const;
+
+    /**
+     * Retorna el mejor autocompletado de una posición
+     * @param p: posición
+     * @return: número de la palabra con mayor prioridad que empieza con el prefijo, o NULO
+     */
+    uint32_t autocomplete(FrozenCursor p) const { return p.node == NULO ? NULO : best[p.node]; }
+
+    /**
+     * Retorna los k mejores autocompletados de una posición, leyendo la lista del nodo
+     * @param p: posición
+     * @param k: cantidad de sugerencias (se usan a lo más top_k)
+     * @return: números de las palabras de mayor a menor prioridad
+     */
+    vector<uint32_t> autocomplete_k(FrozenCursor p, int k) const;
+
+    /**
+     * Retorna una palabra
+     * @param word: número de la palabra
+     * @return: la palabra tal como se insertó
+     */
+    string_view get_word(uint32_t word) const {
+        return string_view(word_chars).substr(word_offsets[word], word_offsets[word + 1] - word_offsets[word]);
+    }
+
+    /**
+     * Busca una palabra
+     * @param w: palabra
+     * @return: su número o NULO si no está en el trie
+     */
+    uint32_t get_terminal(const string& w) const;
+
+    /**
+     * Actualiza prioridad según variante de frecuencia
+     * @param word: número de la palabra
+     */
+    void update_priority_frequency(uint32_t word);
+
+    /**
+     * Actualiza prioridad según variante de reciente
+     * @param word: número de la palabra
+     */
+    void update_priority_recent(uint32_t word);
+
+    /**
+     * Obtiene el número total de nodos en el trie
+     * @return: cantidad de nodos
+     */
+    long long get_node_count() const { return node_count; }
+
+    /**
+     * Obtiene la memoria reservada por el trie congelado
+     * @return: cantidad de bytes
+     */
+    size_t get_memory_bytes() const;
+
+private:
+    /**
+     * Propaga hacia la raíz un aumento de prioridad (ver Trie::propagate_increase)
+     * @param word: número de la palabra
+     */
+    void propagate_increase(uint32_t word);
+
+    /**
+     * Orden de dos palabras con la misma prioridad (ver Trie::tie_before)
+     * @param a: número de palabra
+     * @param b: número de palabra
+     * @return: true si a va antes que b
+     */
+    bool tie_before(uint32_t a, uint32_t b) const;
+
+    /**
+     * Sube en la lista de candidatos de un nodo a una palabra cuya prioridad aumentó (ver Trie::raise_in_top)
+     * @param v: nodo
+     * @param updated: número de la palabra
+     * @return: true si la lista cambió o contiene a updated
+     */
+    bool raise_in_top(uint32_t v, uint32_t updated);
+};
+
+#endif // FROZEN_TRIE_H
@@ -11,6 +11,7 @@ using namespace std;
 const int WINDOW_WIDTH = 1200;
 const int WINDOW_HEIGHT = 800;
 const int MAX_WORDS_TO_LOAD = (1 << 18);  // 2^18
+const int SUGERENCIAS = 4;  // Sugerencias que se muestran por tecla
 
 /**
  * Lee un archivo de palabras desde datasets/
@@ -48,26 +49,35 @@ struct TrieInterface {
     int variant;  // 0 = frecuencia, 1 = reciente
     bool loading;
     
-    TrieInterface() : variant(0), loading(true), current_prefix(""), current_text("") {}
+    TrieInterface() : trie(true, SUGERENCIAS), variant(0), loading(true), current_prefix(""), current_text("") {}
     
     /**
-     * Obtiene la sugerencia actual basada en el prefijo
-     * @return: palabra sugerida o string vacío
+     * Obtiene las sugerencias actuales basadas en el prefijo, de la mejor a la peor
+     * @return: hasta SUGERENCIAS palabras
      */
-    string get_suggestion() {
-        if (current_prefix.empty()) return "";
+    vector<string> get_suggestions() {
+        vector<string> suggestions;
+        if (current_prefix.empty()) return suggestions;
         
-        TrieNode* current = trie.root;
+        TrieCursor current = trie.root;
         for (char c : current_prefix) {
             current = trie.descend(current, tolower(c));
-            if (current == nullptr) return "";
+            if (current.node == nullptr) return suggestions;
         }
         
-        TrieNode* suggestion = trie.autocomplete(current);
-        if (suggestion && suggestion->str) {
-            return *suggestion->str;
+        for (TrieNode* suggestion : trie.autocomplete_k(current.node, SUGERENCIAS)) {
+            suggestions.push_back(trie.get_word(suggestion));
         }
-        return "";
+        return suggestions;
+    }
+    
+    /**
+     * Obtiene la sugerencia actual basada en el prefijo
+     * @return: palabra sugerida o string vacío
+     */
+    string get_suggestion() {
+        vector<string> suggestions = get_suggestions();
+        return suggestions.empty() ? "" : suggestions[0];
     }
     
     /**
@@ -77,11 +87,7 @@ struct TrieInterface {
         string suggestion = get_suggestion();
         if (!suggestion.empty()) {
             // Obtener el nodo terminal para actualizar prioridad
-            TrieNode* current = trie.root;
-            for (char c : suggestion) {
-                current = trie.descend(current, tolower(c));
-            }
-            current = trie.descend(current, '$');
+            TrieNode* current = get_terminal(trie, suggestion);
             
             if (current && variant == 0) {
                 trie.update_priority_frequency(current);
@@ -165,7 +171,8 @@ void draw_interface(TrieInterface& interface, bool loading) {
     
     // Sugerencia
     DrawText("Sugerencia:", 20, input_y + 100, 18, DARKGRAY);
-    string suggestion = interface.get_suggestion();
+    vector<string> suggestions = interface.get_suggestions();
+    string suggestion = suggestions.empty() ? "" : suggestions[0];
     
     // Caja de sugerencia
     DrawRectangle(20, input_y + 130, 400, 50, Color{200, 220, 255, 255});
@@ -177,6 +184,15 @@ void draw_interface(TrieInterface& interface, bool loading) {
         DrawText("(ninguna)", 30, input_y + 140, 18, DARKGRAY);
     }
     
+    // Otras sugerencias, en orden
+    string others = "";
+    for (size_t i = 1; i < suggestions.size(); i++) {
+        others += (i > 1 ? "   " : "") + suggestions[i];
+    }
+    if (!others.empty()) {
+        DrawText(("Otras: " + others).c_str(), 20, input_y + 195, 16, DARKBLUE);
+    }
+    
     // Instrucciones
     DrawText("CONTROLES:", 500, input_y, 18, DARKGRAY);
     DrawText("TAB - Aceptar sugerencia", 500, input_y + 35, 14, DARKBLUE);
@@ -8,272 +8,13 @@
 #include <iomanip>      // Para formatear la salida (setprecision)
 #include <set>          // Para los puntos de medición
 #include <cmath>        // Para pow()
+#include <type_traits>  // Para is_same
+#include "trie.h"
+#include "frozen_trie.h"
 
 
 using namespace std;
 
-const int ALFABETO = 27; // 26 letras + '$'
-
-/**
- * Estructura de un nodo en el Trie
- * Representa un prefijo o una palabra completa en el árbol de búsqueda.
- */
-struct TrieNode {
-    TrieNode* parent;           // Referencia al nodo padre (nullptr si es raíz)
-    TrieNode* next[ALFABETO];   // Mapeo de caracteres a hijos
-    long long priority;         // Prioridad según criterio (frecuencia o reciente)
-    string* str;                // Puntero al string si es nodo terminal
-    TrieNode* best_terminal;    // Puntero al nodo terminal con mayor prioridad del subárbol
-    long long best_priority;    // Prioridad del mejor nodo terminal del subárbol
-    
-    TrieNode() : parent(nullptr), priority(0), str(nullptr), 
-                 best_terminal(nullptr), best_priority(-1) {
-        for (int i = 0; i < ALFABETO; i++) {
-            next[i] = nullptr;
-        }
-    }
-};
-
-// Forward declaration
-void destroy_tree(TrieNode* node);
-
-/**
- * Estructura del Trie
- * Implementa un árbol de prefijos para autocompletado con dos variantes:
- * - Frecuencia: retorna la palabra más accedida
- * - Reciente: retorna la palabra accedida más recientemente
- */
-struct Trie {
-    TrieNode* root;
-    long long node_count;       // Contador de nodos en la estructura
-    long long access_counter;   // Contador de accesos para variante reciente
-    
-    /**
-     * Constructor del Trie
-     * Inicializa la raíz y los contadores
-     */
-    Trie() : node_count(0), access_counter(0) {
-        root = new TrieNode();
-        node_count++;
-    }
-    
-    /**
-     * Convierte un carácter a su índice en next[]
-     * @param c: carácter a convertir
-     * @return: índice en el rango [0, 26], -1 si no es válido
-     */
-    int char_to_index(char c) {
-        if (c == '$') return 26;
-        if (c >= 'a' && c <= 'z') return c - 'a';
-        if (c >= 'A' && c <= 'Z') return c - 'A';
-        return -1;
-    }
-    
-    /**
-     * Verifica si un nodo es un nodo terminal
-     * Un nodo es terminal si es el hijo '$' de su padre
-     * @param node: nodo a verificar
-     * @return: true si es nodo terminal, false en caso contrario
-     */
-    bool is_terminal_node(TrieNode* node) {
-        if (node == nullptr || node->parent == nullptr) return false;
-        int idx = char_to_index('$');
-        return node->parent->next[idx] == node;
-    }
-    /**
- * Inserta una palabra en el trie - VERSIÓN CORREGIDA
- * Crea nodos según sea necesario y marca el final con '$'
- * @param w: palabra a insertar
- */
-void insert(const string& w) {
-    TrieNode* current = root;
-    
-    // Inserta cada carácter
-    for (char c : w) {
-        int idx = char_to_index(tolower(c));
-        if (idx < 0) continue;
-        
-        if (current->next[idx] == nullptr) {
-            current->next[idx] = new TrieNode();
-            current->next[idx]->parent = current;
-            node_count++;
-        }
-        current = current->next[idx];
-    }
-    
-    // Marca el fin de palabra con '$'
-    int idx = char_to_index('$');
-    if (current->next[idx] == nullptr) {
-        current->next[idx] = new TrieNode();
-        current->next[idx]->parent = current;
-        node_count++;
-        
-        // El nodo terminal es el que contiene '$'
-        TrieNode* terminal = current->next[idx];
-        terminal->str = new string(w);
-        terminal->priority = 0;
-        
-        // IMPORTANTE: El nodo terminal es su propio best_terminal
-        terminal->best_terminal = terminal;
-        terminal->best_priority = 0;
-        
-        // CRÍTICO: Propagar inmediatamente después de crear el nodo terminal
-        propagate_best(terminal);
-    }
-    // Si ya existe, no hacer nada (la palabra ya estaba insertada)
-}
-    
-    /**
-     * Desciende por un carácter desde un nodo
-     * @param v: nodo actual
-     * @param c: carácter por el que descender
-     * @return: puntero al nodo hijo o nullptr si no existe
-     */
-    TrieNode* descend(TrieNode* v, char c) {
-        if (v == nullptr) return nullptr;
-        int idx = char_to_index(tolower(c));
-        if (idx < 0) return nullptr;
-        return v->next[idx];
-    }
-    
-    /**
-     * Retorna el mejor autocompletado del subárbol
-     * Retorna el nodo terminal con mayor prioridad en el subárbol
-     * @param v: nodo raíz del subárbol
-     * @return: puntero al nodo terminal con mejor prioridad o nullptr
-     */
-    TrieNode* autocomplete(TrieNode* v) {
-        if (v == nullptr) return nullptr;
-        
-        // Verificar que best_terminal es válido, tiene str y best_priority es válido
-        if (v->best_priority >= 0 && v->best_terminal != nullptr && 
-            v->best_terminal->str != nullptr && is_terminal_node(v->best_terminal)) {
-            return v->best_terminal;
-        }
-        
-        return nullptr;
-    }
-    
-    /**
- * Actualiza prioridad según variante de frecuencia - VERSIÓN CORREGIDA
- * Incrementa la prioridad en 1 y propaga cambios hacia la raíz
- * @param terminal: nodo terminal a actualizar
- */
-void update_priority_frequency(TrieNode* terminal) {
-    if (terminal == nullptr || terminal->str == nullptr) return;
-    if (!is_terminal_node(terminal)) return;
-    
-    terminal->priority++;
-    terminal->best_priority = terminal->priority;  // IMPORTANTE: actualizar best_priority también
-    propagate_best(terminal);
-}
-
-/**
- * Actualiza prioridad según variante de reciente - VERSIÓN CORREGIDA
- * Asigna un timestamp basado en access_counter y propaga cambios
- * @param terminal: nodo terminal a actualizar
- */
-void update_priority_recent(TrieNode* terminal) {
-    if (terminal == nullptr || terminal->str == nullptr) return;
-    if (!is_terminal_node(terminal)) return;
-    
-    terminal->priority = ++access_counter;
-    terminal->best_priority = terminal->priority;  // IMPORTANTE: actualizar best_priority también
-    propagate_best(terminal);
-}
-    
-    /**
- * Propaga la actualización de best_priority y best_terminal hacia la raíz - VERSIÓN CORREGIDA
- * @param v: nodo desde donde propagar (usualmente un nodo terminal recién actualizado)
- */
-void propagate_best(TrieNode* v) {
-    if (v == nullptr) return;
-    
-    // Empezamos desde el padre del nodo que cambió
-    TrieNode* current = v->parent;
-    
-    while (current != nullptr) {
-        long long old_best_priority = current->best_priority;
-        TrieNode* old_best_terminal = current->best_terminal;
-        
-        // Recalcular el mejor hijo
-        current->best_priority = -1;
-        current->best_terminal = nullptr;
-        
-        for (int i = 0; i < ALFABETO; i++) {
-            if (current->next[i] != nullptr) {
-                TrieNode* child = current->next[i];
-                
-                // IMPORTANTE: Solo considerar hijos que tienen un best_terminal válido
-                if (child->best_terminal != nullptr && child->best_priority >= 0) {
-                    // Usar > estricto (no >=) para consistencia
-                    if (current->best_terminal == nullptr || 
-                        child->best_priority > current->best_priority) {
-                        current->best_priority = child->best_priority;
-                        current->best_terminal = child->best_terminal;
-                    }
-                }
-            }
-        }
-        
-        // Optimización: si no hubo cambios, detener propagación
-        if (current->best_priority == old_best_priority && 
-            current->best_terminal == old_best_terminal) {
-            break;
-        }
-        
-        current = current->parent;
-    }
-}
-    
-    /**
-     * Obtiene el número total de nodos en el trie
-     * @return: cantidad de nodos
-     */
-    long long get_node_count() const {
-        return node_count;
-    }
-    
-    /**
-     * Destructor del Trie
-     * Libera toda la memoria utilizada por la estructura
-     */
-    ~Trie() {
-        destroy_tree(root);
-    }
-};
-
-/**
- * Función auxiliar para destruir recursivamente el árbol
- * @param node: nodo raíz del subárbol a destruir
- */
-void destroy_tree(TrieNode* node) {
-    if (node == nullptr) return;
-    for (int i = 0; i < ALFABETO; i++) {
-        destroy_tree(node->next[i]);
-    }
-    if (node->str != nullptr) {
-        delete node->str;
-    }
-    delete node;
-}
-
-/**
- * Función auxiliar para obtener un nodo terminal
- * @param trie: referencia al trie
- * @param word: palabra a buscar
- * @return: puntero al nodo terminal o nullptr si no existe
- */
-TrieNode* get_terminal(Trie& trie, const string& word) {
-    TrieNode* current = trie.root;
-    for (char c : word) {
-        current = trie.descend(current, c);
-        if (current == nullptr) return nullptr;
-    }
-    return trie.descend(current, '$');
-}
-
-
 /**
  * load_words :: String -> Vector
  * Función para cargar un data crear un Vector desde un archivo de texto
@@ -315,16 +56,20 @@ set<long long> create_measurement_points(long long max_val) {
 }
 
 /**
- * run_memory_experiment :: Vector -> void
+ * run_memory_experiment :: Vector, Bool -> void
  * Función encargada de obtener el uso de memoria del Trie en diferentes puntos de su creación.
- * En particular se mide la cantidad de nodos que tiene el Trie para cada potencia de 2 palabras insertadas.
+ * En particular se mide la cantidad de nodos que tiene el Trie para cada potencia de 2 palabras insertadas,
+ * y los bytes que reserva (arena de nodos y tabla de palabras).
+ * Las filas del trie sin comprimir usan el formato Memoria y las del comprimido MemoriaRadix; con el comprimido
+ * también se congela el trie en cada punto y se reportan sus bytes con el formato MemoriaCongelado.
  * @param words: dataset 'words.txt'
+ * @param compressed: si se mide el trie comprimido o el de un nodo por carácter
  */
-void run_memory_experiment(const vector<string>& words) {
-    cout << "\n--- 1. Experimento de Memoria (Seccion 4.1) ---" << endl;
-    cout << "Formato, Insercion_N, Nodos_Totales, Caracteres_Totales, Nodos_Por_Caracter" << endl;
+void run_memory_experiment(const vector<string>& words, bool compressed) {
+    cout << "\n--- 1. Experimento de Memoria (Seccion 4.1, " << (compressed ? "comprimido" : "sin comprimir") << ") ---" << endl;
+    cout << "Formato, Insercion_N, Nodos_Totales, Caracteres_Totales, Nodos_Por_Caracter, Bytes_Totales" << endl;
     
-    Trie trie;
+    Trie trie(compressed);
     long long N = words.size();
     if (N == 0) return;
     
@@ -340,10 +85,19 @@ void run_memory_experiment(const vector<string>& words) {
         if (measurement_points.count(i + 1)) {
             double nodes_per_char = (total_chars_inserted == 0) ? 0 : 
                                     (double)trie.get_node_count() / total_chars_inserted;
-            cout << "Memoria," << (i + 1) << "," 
+            cout << (compressed ? "MemoriaRadix," : "Memoria,") << (i + 1) << "," 
                  << trie.get_node_count() << "," 
                  << total_chars_inserted << "," 
-                 << nodes_per_char << endl;
+                 << nodes_per_char << ","
+                 << trie.get_memory_bytes() << endl;
+            if (compressed) {
+                FrozenTrie frozen = trie.freeze();
+                cout << "MemoriaCongelado," << (i + 1) << ","
+                     << frozen.get_node_count() << ","
+                     << total_chars_inserted << ","
+                     << nodes_per_char << ","
+                     << frozen.get_memory_bytes() << endl;
+            }
         }
     }
 }
@@ -392,14 +146,57 @@ void run_time_experiment(const vector<string>& words) {
     }
 }
 
+/**
+ * Adaptadores de la simulación: la misma simulación corre sobre el trie de punteros (Trie) y sobre el congelado
+ * (FrozenTrie), que tienen cursores y nodos terminales de distinto tipo.
+ */
+TrieCursor sim_start(Trie& trie) { return TrieCursor(trie.root); }
+FrozenCursor sim_start(FrozenTrie& trie) { return trie.start(); }
+bool sim_missing(const TrieCursor& p) { return p.node == nullptr; }
+bool sim_missing(const FrozenCursor& p) { return p.node == NULO; }
+
+/**
+ * Verifica si el autocompletado en la posición actual es la palabra que se está escribiendo
+ * (a mitad de una arista es el del nodo al que lleva)
+ */
+bool sim_suggests(Trie& trie, const TrieCursor& p, const string& w) {
+    TrieNode* suggestion = trie.autocomplete(p.node);
+    return suggestion != nullptr && trie.get_word(suggestion) == w;
+}
+bool sim_suggests(FrozenTrie& trie, const FrozenCursor& p, const string& w) {
+    uint32_t suggestion = trie.autocomplete(p);
+    return suggestion != NULO && trie.get_word(suggestion) == w;
+}
+
+/**
+ * Actualiza la prioridad de la palabra según la variante, si es una palabra del trie
+ */
+void sim_update(Trie& trie, const string& w, bool frequency) {
+    TrieNode* terminal = get_terminal(trie, w);
+    if (terminal == nullptr) return;
+    if (frequency) trie.update_priority_frequency(terminal);
+    else trie.update_priority_recent(terminal);
+}
+void sim_update(FrozenTrie& trie, const string& w, bool frequency) {
+    uint32_t terminal = trie.get_terminal(w);
+    if (terminal == NULO) return;
+    if (frequency) trie.update_priority_frequency(terminal);
+    else trie.update_priority_recent(terminal);
+}
+
 /**
  * run_autocomplete_simulation - VERSIÓN CON DEBUG
  * Incluye verificaciones para entender qué está pasando
+ * Con el trie de punteros es la línea base (formatos Autocompletar y SimTiempo); con el trie congelado, donde después
+ * de construir el diccionario solo cambian las prioridades, las filas usan AutocompletarCongelado y SimTiempoCongelado.
  */
-void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data, 
+template <class TrieT>
+void run_autocomplete_simulation(TrieT& trie, const vector<string>& text_data, 
                                  const string& variant_name, const string& dataset_name) {
+    const string suffix = is_same<TrieT, FrozenTrie>::value ? "Congelado" : "";
     
-    cout << "\n--- 3. Experimento de Autocompletado (" << variant_name << ", " << dataset_name << ") ---" << endl;
+    cout << "\n--- 3. Experimento de Autocompletado (" << variant_name << ", " << dataset_name
+         << (suffix.empty() ? "" : ", congelado") << ") ---" << endl;
     cout << "Formato, Dataset, Variante, Palabra_N, Caracteres_Escritos, Caracteres_Totales, Porcentaje_Escrito" << endl;
     
     long long L = text_data.size();
@@ -418,7 +215,7 @@ void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data,
         const string& w = text_data[i];
         if (w.empty()) continue;
         
-        TrieNode* current = trie.root;
+        auto current = sim_start(trie);
         int chars_typed_count = 0;
         bool word_found_in_trie = false;
         bool autocomplete_success = false;
@@ -428,9 +225,9 @@ void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data,
         // Simular escritura letra por letra
         for (size_t char_idx = 0; char_idx < w.length(); ++char_idx) {
             char c = w[char_idx];
-            TrieNode* next_node = trie.descend(current, c);
+            auto next_node = trie.descend(current, c);
             
-            if (next_node == nullptr) {
+            if (sim_missing(next_node)) {
                 // La palabra no pertenece al trie
                 total_chars_typed += w.length();
                 word_found_in_trie = false;
@@ -443,16 +240,12 @@ void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data,
             word_found_in_trie = true;
             
             // Verificar autocompletado después de cada letra
-            TrieNode* suggestion = trie.autocomplete(current);
-            
-            if (suggestion != nullptr && suggestion->str != nullptr) {
-                if (*(suggestion->str) == w) {
-                    // ¡Autocompletado exitoso!
-                    autocomplete_success = true;
-                    total_chars_typed += chars_typed_count;
-                    successful_autocompletes++;
-                    break;
-                }
+            if (sim_suggests(trie, current, w)) {
+                // ¡Autocompletado exitoso!
+                autocomplete_success = true;
+                total_chars_typed += chars_typed_count;
+                successful_autocompletes++;
+                break;
             }
         }
         
@@ -463,21 +256,14 @@ void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data,
         
         // Actualizar prioridad
         if (word_found_in_trie) {
-            TrieNode* terminal = get_terminal(trie, w);
-            if (terminal != nullptr && trie.is_terminal_node(terminal)) {
-                if (variant_name == "frecuencia") {
-                    trie.update_priority_frequency(terminal);
-                } else {
-                    trie.update_priority_recent(terminal);
-                }
-            }
+            sim_update(trie, w, variant_name == "frecuencia");
         }
         
         // Reportar en los puntos de medición 
         if (measurement_points.count(i + 1)) {
             double percentage_typed = (total_chars_in_text == 0) ? 0 :
                                       (double) total_chars_typed / total_chars_in_text;
-            cout << "Autocompletar," << dataset_name << "," << variant_name << "," 
+            cout << "Autocompletar" << suffix << "," << dataset_name << "," << variant_name << "," 
                  << (i + 1) << "," 
                  << total_chars_typed << "," 
                  << total_chars_in_text << "," 
@@ -489,20 +275,20 @@ void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data,
     long long duration_ms = chrono::duration_cast<chrono::milliseconds>(sim_end_time - sim_start_time).count();
     
     // Información de debug
-    cout << "\n--- Debug Info (" << variant_name << ", " << dataset_name << ") ---" << endl;
+    cout << "\n--- Debug Info (" << variant_name << ", " << dataset_name << suffix << ") ---" << endl;
     cout << "Autocompletados exitosos: " << successful_autocompletes << " de " << L << endl;
     cout << "Palabras no en trie: " << words_not_in_trie << endl;
     double ahorro_porcentual = (total_chars_in_text == 0) ? 0 :
                                 100.0 * (1.0 - (double)total_chars_typed / total_chars_in_text);
     cout << "Ahorro total: " << ahorro_porcentual << "%" << endl;
     
-    cout << "\n--- Resumen de Tiempo de Simulacion (" << variant_name << ", " << dataset_name << ") ---" << endl;
+    cout << "\n--- Resumen de Tiempo de Simulacion (" << variant_name << ", " << dataset_name << suffix << ") ---" << endl;
     cout << "Formato, Dataset, Variante, TiempoTotal_ms, PalabrasTotales, CaracteresTotales, ms_Por_Palabra, ms_Por_Caracter" << endl;
     
     double ms_per_word = (L == 0) ? 0 : (double)duration_ms / L;
     double ms_per_char = (total_chars_in_text == 0) ? 0 : (double)duration_ms / total_chars_in_text;
     
-    cout << "SimTiempo," << dataset_name << "," << variant_name << "," 
+    cout << "SimTiempo" << suffix << "," << dataset_name << "," << variant_name << "," 
          << duration_ms << "," 
          << L << "," 
          << total_chars_in_text << "," 
@@ -510,10 +296,142 @@ void run_autocomplete_simulation(Trie& trie, const vector<string>& text_data,
          << ms_per_char << endl;
 }
 
+/**
+ * run_variant_simulations :: Vector, Vector, Vector, Vector, String, String, String -> void
+ * Corre la simulación de una variante sobre los tres datasets, primero con el trie de punteros sin comprimir (la línea
+ * base) y después, como variante adicional, con un trie comprimido y congelado. Cada trie se construye desde cero con
+ * 'words.txt', y dentro de cada uno las prioridades se acumulan de un dataset al siguiente.
+ * @param words: dataset 'words.txt'
+ * @param wiki_words, rand_words, rand_dist_words: datasets de simulación
+ * @param variant_name: "frecuencia" o "reciente"
+ * @param banner, label: nombre de la variante para los mensajes
+ */
+void run_variant_simulations(const vector<string>& words, const vector<string>& wiki_words,
+                             const vector<string>& rand_words, const vector<string>& rand_dist_words,
+                             const string& variant_name, const string& banner, const string& label) {
+    cout << "\n=============================================" << endl;
+    cout << "INICIANDO SIMULACION: VARIANTE " << banner << endl;
+    cout << "=============================================" << endl;
+
+    { // Se usa un bloque para que el trie se destruya y libere memoria
+        Trie trie;
+        cout << "Construyendo trie para " << label << "..." << endl;
+        for (const string& w : words) {
+            trie.insert(w);
+        }
+        cout << "Trie construido. Nodos: " << trie.get_node_count() << endl;
+
+        if (!wiki_words.empty())
+            run_autocomplete_simulation(trie, wiki_words, variant_name, "wikipedia.txt");
+        if (!rand_words.empty())
+            run_autocomplete_simulation(trie, rand_words, variant_name, "random.txt");
+        if (!rand_dist_words.empty())
+            run_autocomplete_simulation(trie, rand_dist_words, variant_name, "random_with_distribution.txt");
+    }
+
+    FrozenTrie frozen;
+    { // El trie de construcción se destruye al congelarlo
+        Trie trie(true);
+        cout << "Construyendo trie congelado para " << label << "..." << endl;
+        for (const string& w : words) {
+            trie.insert(w);
+        }
+        frozen = trie.freeze();
+    }
+    cout << "Trie congelado. Bytes: " << frozen.get_memory_bytes() << endl;
+
+    if (!wiki_words.empty())
+        run_autocomplete_simulation(frozen, wiki_words, variant_name, "wikipedia.txt");
+    if (!rand_words.empty())
+        run_autocomplete_simulation(frozen, rand_words, variant_name, "random.txt");
+    if (!rand_dist_words.empty())
+        run_autocomplete_simulation(frozen, rand_dist_words, variant_name, "random_with_distribution.txt");
+}
+
+/**
+ * run_topk_simulation :: FrozenTrie, Vector, String, Int -> void
+ * Simula la escritura de un texto mostrando k sugerencias por tecla (variante frecuencia): la palabra se da por
+ * escrita cuando aparece entre las k sugerencias. Mide por separado el tiempo de las consultas (autocomplete_k
+ * en cada prefijo) y el de las actualizaciones de prioridad, que son las que mantienen las listas.
+ * @param trie: trie congelado con listas de largo k
+ * @param text_data: dataset a simular
+ * @param dataset_name: nombre del dataset
+ * @param k: cantidad de sugerencias
+ */
+void run_topk_simulation(FrozenTrie& trie, const vector<string>& text_data, const string& dataset_name, int k) {
+    long long total_chars_typed = 0;
+    long long total_chars_in_text = 0;
+    chrono::nanoseconds query_time(0), update_time(0);
+
+    for (const string& w : text_data) {
+        if (w.empty()) continue;
+        total_chars_in_text += w.length();
+
+        auto t1 = chrono::high_resolution_clock::now();
+        FrozenCursor current = trie.start();
+        long long typed = w.length();
+        for (size_t char_idx = 0; char_idx < w.length(); ++char_idx) {
+            current = trie.descend(current, w[char_idx]);
+            if (current.node == NULO) break;
+            bool found = false;
+            for (uint32_t suggestion : trie.autocomplete_k(current, k)) {
+                if (trie.get_word(suggestion) == w) found = true;
+            }
+            if (found) {
+                typed = char_idx + 1;
+                break;
+            }
+        }
+        auto t2 = chrono::high_resolution_clock::now();
+        total_chars_typed += typed;
+
+        uint32_t terminal = trie.get_terminal(w);
+        if (terminal != NULO) trie.update_priority_frequency(terminal);
+        auto t3 = chrono::high_resolution_clock::now();
+
+        query_time += t2 - t1;
+        update_time += t3 - t2;
+    }
+
+    double percentage_typed = (total_chars_in_text == 0) ? 0 : (double)total_chars_typed / total_chars_in_text;
+    cout << "TopK," << dataset_name << "," << k << ","
+         << trie.get_memory_bytes() << ","
+         << 100 - (percentage_typed * 100.0) << ","
+         << chrono::duration<double, milli>(query_time).count() << ","
+         << chrono::duration<double, milli>(update_time).count() << endl;
+}
+
+/**
+ * run_topk_experiment :: Vector, Vector, Vector, Vector -> void
+ * Compara el costo de mantener listas de k candidatos por nodo: para cada k construye y congela un trie nuevo y
+ * corre los tres datasets de simulación, reportando la memoria, el ahorro y los tiempos de consulta y actualización.
+ * @param words: dataset 'words.txt'
+ * @param wiki_words, rand_words, rand_dist_words: datasets de simulación
+ */
+void run_topk_experiment(const vector<string>& words, const vector<string>& wiki_words,
+                         const vector<string>& rand_words, const vector<string>& rand_dist_words) {
+    cout << "\n--- 4. Experimento de Top-k (frecuencia) ---" << endl;
+    cout << "Formato, Dataset, K, Bytes_Totales, Porcentaje_Ahorrado, Tiempo_Consultas_ms, Tiempo_Actualizaciones_ms" << endl;
+
+    for (int k : {1, 2, 4, 8}) {
+        FrozenTrie frozen;
+        {
+            Trie trie(true, k);
+            for (const string& w : words) {
+                trie.insert(w);
+            }
+            frozen = trie.freeze();
+        }
+        if (!wiki_words.empty()) run_topk_simulation(frozen, wiki_words, "wikipedia.txt", k);
+        if (!rand_words.empty()) run_topk_simulation(frozen, rand_words, "random.txt", k);
+        if (!rand_dist_words.empty()) run_topk_simulation(frozen, rand_dist_words, "random_with_distribution.txt", k);
+    }
+}
+
 /**
  * Función Main
  * Orquesta la carga de archivos y la ejecución de los 3 experimentos
- * para ambas variantes (frecuencia y reciente).
+ * para ambas variantes (frecuencia y reciente), y del experimento de top-k.
  */
 int main() {
     // Configurar precisión de salida para decimales
@@ -555,50 +473,16 @@ int main() {
     
     // --- Ejecución de Experimentos de tiempo y memoria en la creación del Trie ---
     
-    run_memory_experiment(words);
+    run_memory_experiment(words, false);
+    run_memory_experiment(words, true);
     run_time_experiment(words);
     
-    // --- Ejecución de Experimento 3 (Variante Frecuencia) ---
-    { // Se usa un bloque para que el trie se destruya y libere memoria
-        cout << "\n=============================================" << endl;
-        cout << "INICIANDO SIMULACION: VARIANTE FRECUENCIA" << endl;
-        cout << "=============================================" << endl;
-        
-        Trie trie_freq;
-        cout << "Construyendo trie para Frecuencia..." << endl;
-        for (const string& w : words) {
-            trie_freq.insert(w);
-        }
-        cout << "Trie construido. Nodos: " << trie_freq.get_node_count() << endl;
-        
-        if (!wiki_words.empty())
-            run_autocomplete_simulation(trie_freq, wiki_words, "frecuencia", "wikipedia.txt");
-        if (!rand_words.empty())
-            run_autocomplete_simulation(trie_freq, rand_words, "frecuencia", "random.txt");
-        if (!rand_dist_words.empty())
-            run_autocomplete_simulation(trie_freq, rand_dist_words, "frecuencia", "random_with_distribution.txt");
-    }
+    // --- Ejecución de Experimento 3 (Variantes Frecuencia y Reciente) ---
+    run_variant_simulations(words, wiki_words, rand_words, rand_dist_words, "frecuencia", "FRECUENCIA", "Frecuencia");
+    run_variant_simulations(words, wiki_words, rand_words, rand_dist_words, "reciente", "RECIENTE", "Reciente");
     
-    // --- Ejecución de Experimento 3 (Variante Reciente) ---
-    { // Bloque para liberar memoria del trie anterior
-        cout << "\n=============================================" << endl;
-        cout << "INICIANDO SIMULACION: VARIANTE RECIENTE" << endl;
-        cout << "=============================================" << endl;
-        
-        Trie trie_recent;
-        cout << "Construyendo trie para Reciente..." << endl;
-        for (const string& w : words) {
-            trie_recent.insert(w);
-        }
-        cout << "Trie construido. Nodos: " << trie_recent.get_node_count() << endl;
-        
-        if (!wiki_words.empty())
-            run_autocomplete_simulation(trie_recent, wiki_words, "reciente", "wikipedia.txt");
-        if (!rand_words.empty())
-            run_autocomplete_simulation(trie_recent, rand_words, "reciente", "random.txt");
-        if (!rand_dist_words.empty())
-            run_autocomplete_simulation(trie_recent, rand_dist_words, "reciente", "random_with_distribution.txt");
-    }
+    // --- Ejecución de Experimento 4 (listas de k sugerencias) ---
+    run_topk_experiment(words, wiki_words, rand_words, rand_dist_words);
     
     cout << "\n--- Todos los experimentos completados ---" << endl;
     
@@ -0,0 +1,84 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+const uint32_t NULO = UINT32_MAX; // Índice de un nodo que no existe
+
+/**
+ * Arena de nodos por bloques
+ * Reserva los nodos de a bloques contiguos de 2^BITS_BLOQUE y los identifica con índices de 32 bits.
+ * Los bloques no se mueven al crecer, así que un puntero a un nodo sigue siendo válido mientras viva el arena.
+ * free() deja un nodo en una lista de libres que alloc() reutiliza antes de usar espacio nuevo.
+ * Los nodos no se liberan de a uno: release() devuelve todos los bloques de una vez, sin recorrer el árbol.
+ */
+template <class T, uint32_t BITS_BLOQUE = 14>
+struct Slab {
+    static const uint32_t NODOS_POR_BLOQUE = 1u << BITS_BLOQUE;
+    static_assert(is_trivially_destructible<T>::value, "release() no llama destructores de los nodos");
+
+    vector<T*> bloques;
+    vector<uint32_t> libres;
+    uint32_t cantidad;
+
+    Slab() : cantidad(0) {}
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+    ~Slab() { release(); }
+
+    /**
+     * Reserva un nodo (construido con su constructor por defecto), reutilizando uno libre si hay
+     * @return: índice del nodo
+     */
+    uint32_t alloc() {
+        if (!libres.empty()) {
+            uint32_t idx = libres.back();
+            libres.pop_back();
+            new (&(*this)[idx]) T();
+            return idx;
+        }
+        if ((cantidad & (NODOS_POR_BLOQUE - 1)) == 0) {
+            bloques.push_back(static_cast<T*>(::operator new(sizeof(T) * NODOS_POR_BLOQUE)));
+        }
+        new (&bloques.back()[cantidad & (NODOS_POR_BLOQUE - 1)]) T();
+        return cantidad++;
+    }
+
+    /**
+     * Devuelve un nodo al arena para que alloc() lo reutilice
+     * @param idx: índice del nodo
+     */
+    void free(uint32_t idx) { libres.push_back(idx); }
+
+    T& operator[](uint32_t idx) { return bloques[idx >> BITS_BLOQUE][idx & (NODOS_POR_BLOQUE - 1)]; }
+    const T& operator[](uint32_t idx) const { return bloques[idx >> BITS_BLOQUE][idx & (NODOS_POR_BLOQUE - 1)]; }
+
+    /**
+     * Cantidad de nodos en uso
+     * @return: nodos reservados menos los libres
+     */
+    uint32_t size() const { return cantidad - (uint32_t)libres.size(); }
+
+    /**
+     * Bytes reservados por el arena (bloques completos y lista de libres)
+     * @return: cantidad de bytes
+     */
+    size_t bytes() const { return bloques.size() * sizeof(T) * NODOS_POR_BLOQUE + libres.capacity() * sizeof(uint32_t); }
+
+    /**
+     * Libera todos los nodos de una vez devolviendo los bloques
+     */
+    void release() {
+        for (T* bloque : bloques) ::operator delete(bloque);
+        bloques.clear();
+        libres.clear();
+        cantidad = 0;
+    }
+};
+
+#endif // SLAB_H
@@ -1,245 +1,617 @@
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include <cctype>
 #include "trie.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
-const int ALFABETO = 27; // 26 letras + '$'
+/**
+ * Constructor del Trie
+ * Inicializa la raíz (nodo 0 del arena) y los contadores
+ * @param compressed: si se comprimen los caminos o se usa un nodo por carácter
+ * @param top_k: largo de las listas de candidatos de cada nodo
+ */
+Trie::Trie(bool compressed, int top_k)
+    : node_count(0), access_counter(0), compressed(compressed), top_k(max(1, min(top_k, MAX_TOP_K))) {
+    root = &nodes[new_node()];
+    node_count++;
+}
+
+/**
+ * Reserva un nodo nuevo
+ * Con listas de candidatos, agranda top para que el nodo tenga la suya (vacía)
+ * @return: índice del nodo
+ */
+uint32_t Trie::new_node() {
+    uint32_t idx = nodes.alloc();
+    nodes[idx].id = idx;
+    if (top_k > 1 && top.size() < (size_t)(idx + 1) * top_k) top.resize((size_t)(idx + 1) * top_k, NULO);
+    return idx;
+}
+
+/**
+ * Destructor del Trie
+ * Los nodos no guardan memoria propia, así que basta con devolver los bloques de los arenas
+ */
+Trie::~Trie() {
+    nodes.release();
+    nodes4.release();
+    nodes16.release();
+    nodes48.release();
+    nodes256.release();
+}
+
+/**
+ * Convierte un carácter a la llave con que se guarda
+ * Solo las letras ASCII se pasan a minúscula; el resto de los bytes (dígitos, signos, UTF-8) se guarda tal cual
+ * @param c: carácter a convertir
+ * @return: el byte del carácter
+ */
+uint8_t Trie::char_to_index(char c) {
+    if (c >= 'A' && c <= 'Z') return (uint8_t)(c - 'A' + 'a');
+    return (uint8_t)c;
+}
+
+/**
+ * Verifica si un nodo es un nodo terminal
+ * Un nodo es terminal si alguna palabra insertada termina en él
+ * @param node: nodo a verificar
+ * @return: true si es nodo terminal, false en caso contrario
+ */
+bool Trie::is_terminal_node(TrieNode* node) {
+    return node != nullptr && node->word != NULO;
+}
 
 /**
- * Estructura de un nodo en el Trie
- * Representa un prefijo o una palabra completa en el árbol de búsqueda.
+ * Busca la posición donde un nodo guarda su hijo por una llave
+ * Node4 compara las llaves una a una; Node16 las compara todas a la vez con SSE2 (o una a una sin SSE2);
+ * Node48 y Node256 indexan directamente por el byte
+ * @param v: nodo
+ * @param key: llave del hijo
+ * @return: puntero a la posición del hijo en su conjunto o nullptr si no existe
  */
-struct TrieNode {
-    TrieNode* parent;           // Referencia al nodo padre (nullptr si es raíz)
-    TrieNode* next[ALFABETO];   // Mapeo de caracteres a hijos
-    long long priority;         // Prioridad según criterio (frecuencia o reciente)
-    string* str;                // Puntero al string si es nodo terminal
-    TrieNode* best_terminal;    // Puntero al nodo terminal con mayor prioridad del subárbol
-    long long best_priority;    // Prioridad del mejor nodo terminal del subárbol
-    
-    TrieNode() : parent(nullptr), priority(0), str(nullptr), 
-                 best_terminal(nullptr), best_priority(-1) {
-        for (int i = 0; i < ALFABETO; i++) {
-            next[i] = nullptr;
+uint32_t* Trie::find_slot(const TrieNode& v, uint8_t key) {
+    if (v.children == NULO) return nullptr;
+    switch (v.kind) {
+        case NODE4: {
+            Node4& n = nodes4[v.children];
+            for (int i = 0; i < v.count; i++) {
+                if (n.keys[i] == key) return &n.child[i];
+            }
+            return nullptr;
+        }
+        case NODE16: {
+            Node16& n = nodes16[v.children];
+#if defined(__SSE2__)
+            __m128i iguales = _mm_cmpeq_epi8(_mm_set1_epi8((char)key),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(n.keys)));
+            unsigned mascara = (unsigned)_mm_movemask_epi8(iguales) & ((1u << v.count) - 1);
+            return mascara ? &n.child[__builtin_ctz(mascara)] : nullptr;
+#else
+            for (int i = 0; i < v.count; i++) {
+                if (n.keys[i] == key) return &n.child[i];
+            }
+            return nullptr;
+#endif
+        }
+        case NODE48: {
+            Node48& n = nodes48[v.children];
+            return n.index[key] ? &n.child[n.index[key] - 1] : nullptr;
+        }
+        default: {
+            uint32_t* slot = &nodes256[v.children].child[key];
+            return *slot == NULO ? nullptr : slot;
         }
     }
-};
+}
 
-// Forward declaration
-void destroy_tree(TrieNode* node);
+/**
+ * Busca el hijo de un nodo por una llave (el primer carácter de la etiqueta del hijo)
+ * @param v: nodo
+ * @param key: llave del hijo
+ * @return: índice del hijo o NULO si no existe
+ */
+uint32_t Trie::find_child(const TrieNode& v, uint8_t key) {
+    uint32_t* slot = find_slot(v, key);
+    return slot == nullptr ? NULO : *slot;
+}
 
 /**
- * Estructura del Trie
- * Implementa un árbol de prefijos para autocompletado con dos variantes:
- * - Frecuencia: retorna la palabra más accedida
- * - Reciente: retorna la palabra accedida más recientemente
+ * Agrega un hijo a un nodo
+ * En Node4 y Node16 las llaves se mantienen ordenadas, así que los hijos se recorren en orden de byte.
+ * Un conjunto lleno se copia al tipo siguiente y el anterior vuelve a su arena.
+ * @param parent: índice del nodo padre
+ * @param key: llave del hijo
+ * @param child: índice del hijo
  */
-struct Trie {
-    TrieNode* root;
-    long long node_count;       // Contador de nodos en la estructura
-    long long access_counter;   // Contador de accesos para variante reciente
-    
-    /**
-     * Constructor del Trie
-     * Inicializa la raíz y los contadores
-     */
-    Trie() : node_count(0), access_counter(0) {
-        root = new TrieNode();
-        node_count++;
+void Trie::add_child(uint32_t parent, uint8_t key, uint32_t child) {
+    TrieNode& v = nodes[parent];
+    if (v.children == NULO) {
+        v.kind = NODE4;
+        v.children = nodes4.alloc();
     }
-    
-    /**
-     * Convierte un carácter a su índice en next[]
-     * @param c: carácter a convertir
-     * @return: índice en el rango [0, 26], -1 si no es válido
-     */
-    int char_to_index(char c) {
-        if (c == '$') return 26;
-        if (c >= 'a' && c <= 'z') return c - 'a';
-        if (c >= 'A' && c <= 'Z') return c - 'A';
-        return -1;
-    }
-    
-    /**
-     * Verifica si un nodo es un nodo terminal
-     * Un nodo es terminal si es el hijo '$' de su padre
-     * @param node: nodo a verificar
-     * @return: true si es nodo terminal, false en caso contrario
-     */
-    bool is_terminal_node(TrieNode* node) {
-        if (node == nullptr || node->parent == nullptr) return false;
-        int idx = char_to_index('$');
-        return node->parent->next[idx] == node;
+
+    if (v.kind == NODE4 && v.count == 4) {
+        uint32_t nuevo = nodes16.alloc();
+        Node4& viejo = nodes4[v.children];
+        Node16& n = nodes16[nuevo];
+        memcpy(n.keys, viejo.keys, sizeof(viejo.keys));
+        memcpy(n.child, viejo.child, sizeof(viejo.child));
+        nodes4.free(v.children);
+        v.kind = NODE16;
+        v.children = nuevo;
+    } else if (v.kind == NODE16 && v.count == 16) {
+        uint32_t nuevo = nodes48.alloc();
+        Node16& viejo = nodes16[v.children];
+        Node48& n = nodes48[nuevo];
+        memset(n.index, 0, sizeof(n.index));
+        for (int i = 0; i < 16; i++) {
+            n.index[viejo.keys[i]] = (uint8_t)(i + 1);
+            n.child[i] = viejo.child[i];
+        }
+        nodes16.free(v.children);
+        v.kind = NODE48;
+        v.children = nuevo;
+    } else if (v.kind == NODE48 && v.count == 48) {
+        uint32_t nuevo = nodes256.alloc();
+        Node48& viejo = nodes48[v.children];
+        Node256& n = nodes256[nuevo];
+        for (int b = 0; b < ALFABETO; b++) {
+            n.child[b] = viejo.index[b] ? viejo.child[viejo.index[b] - 1] : NULO;
+        }
+        nodes48.free(v.children);
+        v.kind = NODE256;
+        v.children = nuevo;
     }
-    
-    /**
-     * Inserta una palabra en el trie
-     * Crea nodos según sea necesario y marca el final con '$'
-     * @param w: palabra a insertar
-     */
-    void insert(const string& w) {
-        TrieNode* current = root;
-        
-        // Inserta cada carácter
-        for (char c : w) {
-            int idx = char_to_index(tolower(c));
-            if (idx < 0) continue;
-            
-            if (current->next[idx] == nullptr) {
-                current->next[idx] = new TrieNode();
-                current->next[idx]->parent = current;
-                node_count++;
+
+    switch (v.kind) {
+        case NODE4: {
+            Node4& n = nodes4[v.children];
+            int i = v.count;
+            while (i > 0 && n.keys[i - 1] > key) {
+                n.keys[i] = n.keys[i - 1];
+                n.child[i] = n.child[i - 1];
+                i--;
             }
-            current = current->next[idx];
+            n.keys[i] = key;
+            n.child[i] = child;
+            break;
         }
-        
-        // Marca el fin de palabra con '$'
-        int idx = char_to_index('$');
-        if (current->next[idx] == nullptr) {
-            current->next[idx] = new TrieNode();
-            current->next[idx]->parent = current;
-            node_count++;
+        case NODE16: {
+            Node16& n = nodes16[v.children];
+            int i = v.count;
+            while (i > 0 && n.keys[i - 1] > key) {
+                n.keys[i] = n.keys[i - 1];
+                n.child[i] = n.child[i - 1];
+                i--;
+            }
+            n.keys[i] = key;
+            n.child[i] = child;
+            break;
         }
-        
-        // El nodo terminal es el que contiene '$'
-        TrieNode* terminal = current->next[idx];
-        
-        // Si ya existe la palabra, no crear un string duplicado
-        if (terminal->str == nullptr) {
-            terminal->str = new string(w);
-            terminal->priority = 0;
-            terminal->best_terminal = terminal;
-            terminal->best_priority = 0;  // El nodo terminal es su propio mejor resultado
-            
-            // Propagar después de insertar por primera vez
-            propagate_best(terminal);
+        case NODE48: {
+            Node48& n = nodes48[v.children];
+            n.child[v.count] = child;
+            n.index[key] = (uint8_t)(v.count + 1);
+            break;
         }
+        default:
+            nodes256[v.children].child[key] = child;
     }
-    
-    /**
-     * Desciende por un carácter desde un nodo
-     * @param v: nodo actual
-     * @param c: carácter por el que descender
-     * @return: puntero al nodo hijo o nullptr si no existe
-     */
-    TrieNode* descend(TrieNode* v, char c) {
-        if (v == nullptr) return nullptr;
-        int idx = char_to_index(tolower(c));
-        if (idx < 0) return nullptr;
-        return v->next[idx];
+    v.count++;
+}
+
+/**
+ * Retorna un carácter de la etiqueta de la arista que llega a un nodo
+ * @param v: nodo
+ * @param i: posición en la etiqueta
+ * @return: el byte del carácter
+ */
+uint8_t Trie::label_at(const TrieNode& v, uint32_t i) {
+    return char_to_index(words[v.label_word][v.label_start + i]);
+}
+
+/**
+ * Crea los nodos para el resto de una palabra bajo un nodo
+ * Comprimido basta un nodo cuya etiqueta es todo el resto; sin comprimir se crea un nodo por carácter.
+ * Las etiquetas apuntan a la palabra, que se agrega a words al terminar la inserción.
+ * @param parent: índice del nodo padre
+ * @param word: índice que tendrá la palabra en words
+ * @param w: palabra
+ * @param from: posición del primer carácter que falta
+ * @return: índice del último nodo creado
+ */
+uint32_t Trie::add_tail(uint32_t parent, uint32_t word, const string& w, size_t from) {
+    while (from < w.size()) {
+        uint32_t len = compressed ? (uint32_t)(w.size() - from) : 1;
+        uint32_t child = new_node();
+        TrieNode& n = nodes[child];
+        n.parent = parent;
+        n.label_word = word;
+        n.label_start = (uint32_t)from;
+        n.label_len = len;
+        add_child(parent, char_to_index(w[from]), child);
+        node_count++;
+        parent = child;
+        from += len;
     }
-    
-    /**
-     * Retorna el mejor autocompletado del subárbol
-     * Retorna el nodo terminal con mayor prioridad en el subárbol
-     * @param v: nodo raíz del subárbol
-     * @return: puntero al nodo terminal con mejor prioridad o nullptr
-     */
-    TrieNode* autocomplete(TrieNode* v) {
-        if (v == nullptr) return nullptr;
-        
-        // Verificar que best_terminal es válido, tiene str y best_priority es válido
-        if (v->best_priority >= 0 && v->best_terminal != nullptr && 
-            v->best_terminal->str != nullptr && is_terminal_node(v->best_terminal)) {
-            return v->best_terminal;
+    return parent;
+}
+
+/**
+ * Parte la arista que llega a un nodo dejando un nodo intermedio después de sus primeros len caracteres
+ * El intermedio toma el lugar del nodo en su padre y queda con el nodo como único hijo, así que su mejor
+ * terminal y su lista de candidatos son los del nodo y no hace falta propagar nada.
+ * @param node: índice del nodo
+ * @param len: caracteres de la etiqueta que quedan sobre el nodo intermedio
+ * @return: índice del nodo intermedio
+ */
+uint32_t Trie::split_edge(uint32_t node, uint32_t len) {
+    uint32_t mid = new_node();
+    TrieNode& v = nodes[node];
+    TrieNode& m = nodes[mid];
+    m.parent = v.parent;
+    m.label_word = v.label_word;
+    m.label_start = v.label_start;
+    m.label_len = len;
+    *find_slot(nodes[v.parent], label_at(v, 0)) = mid;
+
+    v.parent = mid;
+    v.label_start += len;
+    v.label_len -= len;
+    add_child(mid, label_at(v, 0), node);
+    m.best_priority = v.best_priority;
+    m.best_terminal = v.best_terminal;
+    if (top_k > 1) copy_n(top.begin() + (size_t)node * top_k, top_k, top.begin() + (size_t)mid * top_k);
+    node_count++;
+    return mid;
+}
+
+/**
+ * Inserta una palabra en el trie
+ * Baja por las aristas mientras coinciden; si la palabra se separa a mitad de una arista, la parte en ese
+ * punto, y el resto de la palabra se cuelga del último nodo. Marca como terminal el nodo donde termina la palabra.
+ * @param w: palabra a insertar
+ */
+void Trie::insert(const string& w) {
+    uint32_t word = (uint32_t)words.size();
+    uint32_t current = 0;
+    size_t i = 0;
+
+    while (i < w.size()) {
+        uint32_t child = find_child(nodes[current], char_to_index(w[i]));
+        if (child == NULO) {
+            current = add_tail(current, word, w, i);
+            break;
+        }
+
+        // El primer carácter de la etiqueta es la llave; se compara el resto
+        const TrieNode& edge = nodes[child];
+        uint32_t j = 1;
+        i++;
+        while (j < edge.label_len && i < w.size() && label_at(edge, j) == char_to_index(w[i])) {
+            j++;
+            i++;
         }
-        
-        return nullptr;
+        current = (j < edge.label_len) ? split_edge(child, j) : child;
+    }
+
+    TrieNode& terminal = nodes[current];
+    if (terminal.word == NULO) {
+        terminal.word = word;
+        words.push_back(w);
+        terminal.priority = 0;
+
+        // Propagar inmediatamente después de marcar el nodo terminal
+        propagate_best(&terminal);
     }
-    
-    /**
-     * Actualiza prioridad según variante de frecuencia
-     * Incrementa la prioridad en 1 y propaga cambios hacia la raíz
-     * @param terminal: nodo terminal a actualizar
-     */
-    void update_priority_frequency(TrieNode* terminal) {
-        if (terminal == nullptr || terminal->str == nullptr) return;
-        
-        terminal->priority++;
-        propagate_best(terminal);
+    // Si ya existe, no hacer nada (la palabra ya estaba insertada)
+}
+
+/**
+ * Avanza un carácter desde una posición
+ * Si queda etiqueta por recorrer compara con su siguiente carácter; si no, baja al hijo cuya etiqueta empieza
+ * con el carácter.
+ * @param p: posición actual
+ * @param c: carácter por el que descender
+ * @return: la nueva posición (con node en nullptr si el prefijo no está en el trie)
+ */
+TrieCursor Trie::descend(TrieCursor p, char c) {
+    if (p.node == nullptr) return TrieCursor();
+    uint8_t key = char_to_index(c);
+
+    if (p.offset < p.node->label_len) {
+        if (label_at(*p.node, p.offset) != key) return TrieCursor();
+        p.offset++;
+        return p;
     }
-    
-    /**
-     * Actualiza prioridad según variante de reciente
-     * Asigna un timestamp basado en access_counter y propaga cambios
-     * @param terminal: nodo terminal a actualizar
-     */
-    void update_priority_recent(TrieNode* terminal) {
-        if (terminal == nullptr || terminal->str == nullptr) return;
-        
-        terminal->priority = ++access_counter;
-        propagate_best(terminal);
+
+    uint32_t child = find_child(*p.node, key);
+    if (child == NULO) return TrieCursor();
+    p.node = &nodes[child];
+    p.offset = 1;
+    return p;
+}
+
+/**
+ * Retorna el mejor autocompletado del subárbol
+ * Retorna el nodo terminal con mayor prioridad en el subárbol
+ * @param v: nodo raíz del subárbol
+ * @return: puntero al nodo terminal con mejor prioridad o nullptr
+ */
+TrieNode* Trie::autocomplete(TrieNode* v) {
+    if (v == nullptr) return nullptr;
+
+    // Verificar que best_terminal es válido y best_priority es válido
+    if (v->best_priority >= 0 && v->best_terminal != NULO) {
+        TrieNode* best = &nodes[v->best_terminal];
+        if (is_terminal_node(best)) return best;
     }
-    
-    /**
-     * Propaga la actualización de best_priority y best_terminal hacia la raíz
-     * Actualiza el mejor nodo terminal de cada nodo en el camino a la raíz
-     * @param v: nodo terminal que fue actualizado
-     */
-    void propagate_best(TrieNode* v) {
-        TrieNode* current = v->parent;
-        
-        while (current != nullptr) {
-            long long old_best_priority = current->best_priority;
-            TrieNode* old_best_terminal = current->best_terminal;
-            
-            // Reiniciar best_priority del nodo actual
-            current->best_priority = -1;
-            current->best_terminal = nullptr;
-            
-            // Buscar el hijo con mejor prioridad
-            for (int i = 0; i < ALFABETO; i++) {
-                if (current->next[i] != nullptr) {
-                    TrieNode* child = current->next[i];
-                    if (child->best_priority > current->best_priority) {
-                        current->best_priority = child->best_priority;
-                        current->best_terminal = child->best_terminal;
-                    }
-                }
-            }
-            
-            // Si no hubo cambios, se puede detener la propagación
-            if (current->best_priority == old_best_priority && 
-                current->best_terminal == old_best_terminal) {
-                break;
+
+    return nullptr;
+}
+
+/**
+ * Retorna los k mejores autocompletados del subárbol
+ * La lista del nodo ya está ordenada, así que basta copiar sus primeros k elementos.
+ * Sin listas (top_k = 1) retorna a lo más best_terminal.
+ * @param v: nodo raíz del subárbol
+ * @param k: cantidad de sugerencias (se usan a lo más top_k)
+ * @return: nodos terminales de mayor a menor prioridad
+ */
+vector<TrieNode*> Trie::autocomplete_k(TrieNode* v, int k) {
+    vector<TrieNode*> result;
+    if (v == nullptr || k <= 0) return result;
+    if (top_k == 1) {
+        TrieNode* best = autocomplete(v);
+        if (best != nullptr) result.push_back(best);
+        return result;
+    }
+
+    const uint32_t* lista = &top[(size_t)v->id * top_k];
+    for (int i = 0; i < min(k, top_k) && lista[i] != NULO; i++) {
+        result.push_back(&nodes[lista[i]]);
+    }
+    return result;
+}
+
+/**
+ * Retorna la palabra de un nodo terminal
+ * @param terminal: nodo terminal
+ * @return: la palabra tal como se insertó
+ */
+const string& Trie::get_word(TrieNode* terminal) {
+    return words[terminal->word];
+}
+
+/**
+ * Actualiza prioridad según variante de frecuencia
+ * Incrementa la prioridad en 1 y propaga cambios hacia la raíz
+ * @param terminal: nodo terminal a actualizar
+ */
+void Trie::update_priority_frequency(TrieNode* terminal) {
+    if (!is_terminal_node(terminal)) return;
+
+    terminal->priority++;
+    propagate_increase(terminal);
+}
+
+/**
+ * Actualiza prioridad según variante de reciente
+ * Asigna un timestamp basado en access_counter y propaga cambios
+ * @param terminal: nodo terminal a actualizar
+ */
+void Trie::update_priority_recent(TrieNode* terminal) {
+    if (!is_terminal_node(terminal)) return;
+
+    terminal->priority = ++access_counter;
+    propagate_increase(terminal);
+}
+
+/**
+ * Recalcula best_priority y best_terminal de un nodo
+ * Los hijos se recorren en orden de byte y la palabra propia del nodo se considera al final, siempre con >
+ * estricto: ante un empate gana el hijo de menor byte, y la palabra propia solo si supera a todos sus hijos.
+ * @param v: nodo a recalcular
+ */
+void Trie::recompute_best(TrieNode& v) {
+    v.best_priority = -1;
+    v.best_terminal = NULO;
+
+    for_each_child(v, [&](uint8_t, uint32_t child_idx) {
+        const TrieNode& child = nodes[child_idx];
+        // Solo considerar hijos que tienen un best_terminal válido
+        if (child.best_terminal != NULO && child.best_priority >= 0) {
+            if (v.best_terminal == NULO || child.best_priority > v.best_priority) {
+                v.best_priority = child.best_priority;
+                v.best_terminal = child.best_terminal;
             }
-            
-            current = current->parent;
         }
+    });
+
+    if (v.word != NULO && (v.best_terminal == NULO || v.priority > v.best_priority)) {
+        v.best_priority = v.priority;
+        v.best_terminal = v.id;
+    }
+}
+
+/**
+ * Recalcula la lista de candidatos de un nodo
+ * Ofrece las listas de los hijos en orden de byte y luego la palabra propia; cada candidato se inserta después de
+ * los de igual prioridad, así que los empates se resuelven igual que en recompute_best. La lista de un hijo está
+ * ordenada, así que se deja de leer cuando un candidato ya no entra.
+ * @param v: nodo a recalcular
+ * @param updated: nodo terminal cuya prioridad cambió
+ * @return: true si la lista cambió o contiene a updated
+ */
+bool Trie::recompute_top(TrieNode& v, uint32_t updated) {
+    uint32_t nueva[MAX_TOP_K];
+    long long prioridades[MAX_TOP_K];
+    int n = 0;
+
+    // Retorna false si el candidato no entró
+    auto ofrecer = [&](uint32_t id) {
+        long long p = nodes[id].priority;
+        if (n == top_k && p <= prioridades[n - 1]) return false;
+        int i = (n < top_k) ? n++ : n - 1;
+        while (i > 0 && prioridades[i - 1] < p) {
+            nueva[i] = nueva[i - 1];
+            prioridades[i] = prioridades[i - 1];
+            i--;
+        }
+        nueva[i] = id;
+        prioridades[i] = p;
+        return true;
+    };
+
+    for_each_child(v, [&](uint8_t, uint32_t child) {
+        const uint32_t* lista = &top[(size_t)child * top_k];
+        for (int i = 0; i < top_k && lista[i] != NULO; i++) {
+            if (!ofrecer(lista[i])) break;
+        }
+    });
+    if (v.word != NULO) ofrecer(v.id);
+
+    uint32_t* lista = &top[(size_t)v.id * top_k];
+    bool changed = false;
+    for (int i = 0; i < top_k; i++) {
+        uint32_t id = (i < n) ? nueva[i] : NULO;
+        if (lista[i] != id || (id != NULO && id == updated)) changed = true;
+        lista[i] = id;
+    }
+    return changed;
+}
+
+/**
+ * Propaga la actualización de best_priority y best_terminal hacia la raíz
+ * Recalcula el nodo y luego cada ancestro, y se detiene cuando un ancestro no cambia (ni su lista de candidatos).
+ * En el trie comprimido los ancestros son solo los nodos de bifurcación o con palabra, no uno por carácter.
+ * @param v: nodo terminal que fue actualizado
+ */
+void Trie::propagate_best(TrieNode* v) {
+    if (v == nullptr) return;
+    recompute_best(*v);
+    if (top_k > 1) recompute_top(*v, v->id);
+
+    uint32_t current = v->parent;
+    while (current != NULO) {
+        TrieNode& node = nodes[current];
+        long long old_priority = node.best_priority;
+        uint32_t old_terminal = node.best_terminal;
+
+        recompute_best(node);
+        bool top_changed = top_k > 1 && recompute_top(node, v->id);
+
+        // Si no cambió nada, no es necesario seguir propagando
+        if (node.best_priority == old_priority && node.best_terminal == old_terminal && !top_changed) break;
+        current = node.parent;
     }
-    
-    /**
-     * Obtiene el número total de nodos en el trie
-     * @return: cantidad de nodos
-     */
-    long long get_node_count() const {
-        return node_count;
+}
+
+/**
+ * Orden de dos palabras con la misma prioridad
+ * Las dos palabras están en el subárbol del ancestro que las compara, así que el primer byte donde difieren es
+ * el de los hijos por los que bajan; si una es prefijo de la otra, es la palabra propia de un nodo y va después.
+ * @param a: nodo terminal
+ * @param b: nodo terminal
+ * @return: true si a va antes que b
+ */
+bool Trie::tie_before(uint32_t a, uint32_t b) {
+    const string& wa = words[nodes[a].word];
+    const string& wb = words[nodes[b].word];
+    size_t i = 0;
+    while (i < wa.size() && i < wb.size() && char_to_index(wa[i]) == char_to_index(wb[i])) i++;
+    if (i == wa.size()) return false;
+    if (i == wb.size()) return true;
+    return char_to_index(wa[i]) < char_to_index(wb[i]);
+}
+
+/**
+ * Sube un nodo terminal en la lista de candidatos de un nodo
+ * Como las demás prioridades no cambiaron, la lista nueva es la anterior sin updated y con updated insertado en
+ * su lugar (si entra).
+ * @param v: índice del nodo
+ * @param updated: nodo terminal cuya prioridad aumentó
+ * @return: true si la lista cambió o contiene a updated
+ */
+bool Trie::raise_in_top(uint32_t v, uint32_t updated) {
+    uint32_t* lista = &top[(size_t)v * top_k];
+    long long p = nodes[updated].priority;
+
+    // Se saca updated si estaba
+    int n = 0;
+    for (int i = 0; i < top_k && lista[i] != NULO; i++) {
+        if (lista[i] != updated) lista[n++] = lista[i];
     }
-    
-    /**
-     * Destructor del Trie
-     * Libera toda la memoria utilizada por la estructura
-     */
-    ~Trie() {
-        destroy_tree(root);
+
+    int i = n;
+    while (i > 0 && (nodes[lista[i - 1]].priority < p ||
+                     (nodes[lista[i - 1]].priority == p && tie_before(updated, lista[i - 1])))) {
+        i--;
     }
-};
+    if (i == top_k) return false; // La lista está llena y updated no le gana a ninguno
+
+    for (int j = min(n, top_k - 1); j > i; j--) lista[j] = lista[j - 1];
+    lista[i] = updated;
+    return true;
+}
 
 /**
- * Función auxiliar para destruir recursivamente el árbol
- * @param node: nodo raíz del subárbol a destruir
+ * Propaga hacia la raíz un aumento de prioridad
+ * Las demás prioridades no cambiaron, así que en cada ancestro basta comparar el nodo actualizado con el mejor
+ * actual (y subirlo en la lista de candidatos): si ya era el mejor sigue siéndolo, si le gana pasa a serlo, y si
+ * pierde ese ancestro y los de arriba no cambian. Cada paso es O(top_k), sin recorrer los hijos.
+ * @param v: nodo terminal cuya prioridad aumentó
  */
-void destroy_tree(TrieNode* node) {
-    if (node == nullptr) return;
-    for (int i = 0; i < ALFABETO; i++) {
-        destroy_tree(node->next[i]);
+void Trie::propagate_increase(TrieNode* v) {
+    if (v == nullptr) return;
+    uint32_t updated = v->id;
+    long long p = v->priority;
+
+    for (uint32_t current = updated; current != NULO; current = nodes[current].parent) {
+        TrieNode& node = nodes[current];
+        bool changed = false;
+        if (node.best_terminal == updated) {
+            node.best_priority = p;
+            changed = true;
+        } else if (node.best_terminal == NULO || p > node.best_priority ||
+                   (p == node.best_priority && tie_before(updated, node.best_terminal))) {
+            node.best_terminal = updated;
+            node.best_priority = p;
+            changed = true;
+        }
+        if (top_k > 1 && raise_in_top(current, updated)) changed = true;
+
+        // Si perdió contra el mejor de este ancestro, los de arriba tampoco cambian
+        if (!changed) break;
     }
-    if (node->str != nullptr) {
-        delete node->str;
+}
+
+/**
+ * Obtiene el número total de nodos en el trie
+ * @return: cantidad de nodos
+ */
+long long Trie::get_node_count() const {
+    return node_count;
+}
+
+/**
+ * Obtiene la memoria reservada por el trie (arenas de nodos y de hijos, y tabla de palabras)
+ * @return: cantidad de bytes
+ */
+size_t Trie::get_memory_bytes() const {
+    size_t bytes = nodes.bytes() + nodes4.bytes() + nodes16.bytes() + nodes48.bytes() + nodes256.bytes();
+    bytes += top.capacity() * sizeof(uint32_t);
+    bytes += words.capacity() * sizeof(string);
+    const size_t en_linea = string().capacity();
+    for (const string& w : words) {
+        if (w.capacity() > en_linea) bytes += w.capacity() + 1;
     }
-    delete node;
+    return bytes;
 }
 
 /**
@@ -249,90 +621,10 @@ void destroy_tree(TrieNode* node) {
  * @return: puntero al nodo terminal o nullptr si no existe
  */
 TrieNode* get_terminal(Trie& trie, const string& word) {
-    TrieNode* current = trie.root;
+    TrieCursor current = trie.root;
     for (char c : word) {
         current = trie.descend(current, c);
-        if (current == nullptr) return nullptr;
-    }
-    return trie.descend(current, '$');
-}
-
-/*
-int main() {
-    Trie trie;
-    
-    // Insertar palabras
-    trie.insert("apple");
-    trie.insert("application");
-    trie.insert("apply");
-    trie.insert("appreciate");
-    
-    cout << "Nodos creados: " << trie.get_node_count() << endl;
-    
-    // Obtener referencias a los nodos terminales
-    TrieNode* term_apple = get_terminal(trie, "apple");
-    TrieNode* term_application = get_terminal(trie, "application");
-    TrieNode* term_apply = get_terminal(trie, "apply");
-    TrieNode* term_appreciate = get_terminal(trie, "appreciate");
-    
-    cout << "\n--- ANTES de actualizar prioridades ---" << endl;
-    TrieNode* node_a = trie.descend(trie.root, 'a');
-    if (node_a) {
-        TrieNode* best = trie.autocomplete(node_a);
-        if (best && best->str) {
-            cout << "Mejor autocompletado desde 'a': " << *best->str 
-                 << " (prioridad: " << best->priority << ")" << endl;
-        }
-    }
-    
-    // Simular accesos con diferentes frecuencias
-    cout << "\n--- Actualizando prioridades (FRECUENCIA) ---" << endl;
-    if (term_apple && trie.is_terminal_node(term_apple)) {
-        trie.update_priority_frequency(term_apple);
-        trie.update_priority_frequency(term_apple);
-        trie.update_priority_frequency(term_apple);
-        cout << "apple: +3 accesos (prioridad: " << term_apple->priority << ")" << endl;
-    }
-    
-    if (term_application && trie.is_terminal_node(term_application)) {
-        trie.update_priority_frequency(term_application);
-        trie.update_priority_frequency(term_application);
-        cout << "application: +2 accesos (prioridad: " << term_application->priority << ")" << endl;
-    }
-    
-    if (term_apply && trie.is_terminal_node(term_apply)) {
-        trie.update_priority_frequency(term_apply);
-        cout << "apply: +1 acceso (prioridad: " << term_apply->priority << ")" << endl;
-    }
-    
-    if (term_appreciate && trie.is_terminal_node(term_appreciate)) {
-        cout << "appreciate: sin accesos (prioridad: " << term_appreciate->priority << ")" << endl;
-    }
-    
-    cout << "\n--- DESPUES de actualizar prioridades ---" << endl;
-    node_a = trie.descend(trie.root, 'a');
-    if (node_a) {
-        TrieNode* best = trie.autocomplete(node_a);
-        if (best && best->str) {
-            cout << "Mejor autocompletado desde 'a': " << *best->str 
-                 << " (prioridad: " << best->priority << ")" << endl;
-        }
-        
-        TrieNode* node_ap = trie.descend(node_a, 'p');
-        if (node_ap) {
-            best = trie.autocomplete(node_ap);
-            if (best && best->str) {
-                cout << "Mejor autocompletado desde 'ap': " << *best->str 
-                     << " (prioridad: " << best->priority << ")" << endl;
-            }
-        }
+        if (current.node == nullptr) return nullptr;
     }
-    
-    // Prueba de inserción duplicada
-    cout << "\n--- Prueba de palabra duplicada ---" << endl;
-    trie.insert("apple");  // Insertar "apple" de nuevo
-    cout << "Nodos después de insertar 'apple' duplicado: " << trie.get_node_count() << endl;
-    
-    return 0;
+    return current.at_node() && trie.is_terminal_node(current.node) ? current.node : nullptr;
 }
-*/
\ No newline at end of file
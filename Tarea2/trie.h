@@ -2,118 +2,359 @@
 #define TRIE_H
 
 #include <string> // Required for std::string
+#include <vector>
+#include "slab.h"
 
 using namespace std;
 
-const int ALFABETO = 27; // 26 letras + '$'
+struct FrozenTrie;
+
+const int ALFABETO = 256; // Cualquier byte (las letras ASCII se guardan en minúscula)
+const int MAX_TOP_K = 16; // Largo máximo de las listas de candidatos por nodo
+
+/**
+ * Tipos de nodo según la cantidad de hijos (nodos adaptativos de un árbol radix)
+ * Un nodo guarda sus hijos en el conjunto más chico donde caben, y pasa al siguiente cuando se llena.
+ */
+enum TipoNodo : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+/**
+ * Hasta 4 hijos: llaves ordenadas y búsqueda lineal
+ */
+struct Node4 {
+    uint8_t keys[4];
+    uint32_t child[4];
+};
+
+/**
+ * Hasta 16 hijos: llaves ordenadas, la búsqueda compara las 16 llaves a la vez con SSE2
+ */
+struct Node16 {
+    uint8_t keys[16];
+    uint32_t child[16];
+};
+
+/**
+ * Hasta 48 hijos: index[byte] es la posición del hijo en child más uno (0 si no hay hijo)
+ */
+struct Node48 {
+    uint8_t index[ALFABETO];
+    uint32_t child[48];
+};
+
+/**
+ * Hasta 256 hijos: un hijo por byte
+ */
+struct Node256 {
+    uint32_t child[ALFABETO];
+};
 
 /**
  * Estructura de un nodo en el Trie
  * Representa un prefijo o una palabra completa en el árbol de búsqueda.
+ * Los nodos viven en el arena del Trie y se refieren entre sí por índice (NULO si no existe).
+ * Los hijos están en el conjunto children del arena de su tipo; un nodo sin hijos no reserva ninguno.
+ * La arista que llega al nodo lleva una etiqueta: los label_len caracteres de Trie::words[label_word] desde
+ * label_start (en el trie comprimido puede ser más de uno; la raíz no tiene etiqueta).
+ * Si una palabra termina en este nodo, word y priority son los de esa palabra.
  */
 struct TrieNode {
-    TrieNode* parent;           // Referencia al nodo padre (nullptr si es raíz)
-    TrieNode* next[ALFABETO];   // Mapeo de caracteres a hijos
+    uint32_t id;                // Índice del nodo en el arena
+    uint32_t parent;            // Índice del nodo padre (NULO si es raíz)
+    uint32_t best_terminal;     // Índice del nodo terminal con mayor prioridad del subárbol
+    uint32_t word;              // Índice de la palabra en Trie::words si es nodo terminal, NULO si no
+    uint32_t children;          // Índice del conjunto de hijos en el arena de su tipo (NULO si no tiene hijos)
+    uint32_t label_word;        // Palabra de Trie::words que contiene la etiqueta de la arista
+    uint32_t label_start;       // Posición de la etiqueta en esa palabra
+    uint32_t label_len;         // Largo de la etiqueta
+    TipoNodo kind;              // Tipo del conjunto de hijos
+    uint16_t count;             // Cantidad de hijos
     long long priority;         // Prioridad según criterio (frecuencia o reciente)
-    string* str;                // Puntero al string si es nodo terminal
-    TrieNode* best_terminal;    // Puntero al nodo terminal con mayor prioridad del subárbol
     long long best_priority;    // Prioridad del mejor nodo terminal del subárbol
-    
-    TrieNode() : parent(nullptr), priority(0), str(nullptr), 
-                 best_terminal(nullptr), best_priority(-1) {
-        for (int i = 0; i < ALFABETO; i++) {
-            next[i] = nullptr;
-        }
-    }
+
+    TrieNode() : id(NULO), parent(NULO), best_terminal(NULO), word(NULO), children(NULO), label_word(NULO),
+                 label_start(0), label_len(0), kind(NODE4), count(0), priority(0), best_priority(-1) {}
 };
 
-// Forward declaration for helper function
-void destroy_tree(TrieNode* node);
+/**
+ * Posición en el Trie después de escribir un prefijo
+ * Con aristas de varios caracteres el prefijo puede terminar a mitad de una arista: node es el nodo al que lleva
+ * la arista y offset los caracteres ya recorridos de su etiqueta. El subárbol de node tiene justo las palabras que
+ * empiezan con el prefijo, así que el autocompletado es el de node aunque el prefijo no llegue hasta él.
+ * Se construye desde un nodo (por ejemplo trie.root) con la etiqueta ya recorrida completa.
+ */
+struct TrieCursor {
+    TrieNode* node;             // Nodo al que lleva la arista actual (nullptr si el prefijo no está en el trie)
+    uint32_t offset;            // Caracteres recorridos de la etiqueta de node
+
+    TrieCursor(TrieNode* n = nullptr) : node(n), offset(n ? n->label_len : 0) {}
+
+    /**
+     * Verifica si la posición está justo en node (y no a mitad de su arista)
+     * @return: true si se recorrió toda la etiqueta
+     */
+    bool at_node() const { return node != nullptr && offset == node->label_len; }
+};
 
 /**
  * Estructura del Trie
  * Implementa un árbol de prefijos para autocompletado con dos variantes:
  * - Frecuencia: retorna la palabra más accedida
  * - Reciente: retorna la palabra accedida más recientemente
+ * Los nodos se reservan en un arena por bloques, así que los punteros TrieNode* que entrega siguen siendo
+ * válidos mientras viva el Trie, y destruirlo libera los bloques de una vez.
+ * Por defecto cada arista tiene un carácter, como el trie original. Comprimido (radix/Patricia), una cadena de nodos
+ * con un solo hijo y sin palabra se guarda como un nodo cuya arista lleva todos esos caracteres.
+ * Con top_k > 1 cada nodo mantiene además las top_k mejores palabras de su subárbol, en el mismo orden que
+ * best_terminal (prioridad, y ante empates el hijo de menor byte y luego la palabra propia).
  */
 struct Trie {
+    Slab<TrieNode> nodes;       // Arena con todos los nodos; la raíz es el nodo 0
+    Slab<Node4> nodes4;         // Conjuntos de hijos de cada tipo
+    Slab<Node16, 12> nodes16;
+    Slab<Node48, 10> nodes48;
+    Slab<Node256, 8> nodes256;
+    vector<string> words;       // Palabras de los nodos terminales
     TrieNode* root;
     long long node_count;       // Contador de nodos en la estructura
     long long access_counter;   // Contador de accesos para variante reciente
-    
+    bool compressed;            // Si las aristas nuevas llevan todo el resto de la palabra o un solo carácter
+    int top_k;                  // Largo de las listas de candidatos (1: solo best_terminal)
+    vector<uint32_t> top;       // Con top_k > 1, top_k nodos terminales por nodo (top[id * top_k + i], NULO al final)
+
     /**
      * Constructor del Trie
      * Inicializa la raíz y los contadores
+     * @param compressed: si se comprimen los caminos o se usa un nodo por carácter (por defecto)
+     * @param top_k: largo de las listas de candidatos de cada nodo (entre 1 y MAX_TOP_K)
      */
-    Trie() : node_count(0), access_counter(0) {
-        root = new TrieNode();
-        node_count++;
-    }
-    
+    explicit Trie(bool compressed = false, int top_k = 1);
+
     /**
      * Destructor del Trie
      * Libera toda la memoria utilizada por la estructura
      */
     ~Trie();
-    
+
+    Trie(const Trie&) = delete;
+    Trie& operator=(const Trie&) = delete;
+
     /**
-     * Convierte un carácter a su índice en next[]
+     * Convierte un carácter a la llave con que se guarda
      * @param c: carácter a convertir
-     * @return: índice en el rango [0, 26], -1 si no es válido
+     * @return: el byte del carácter, con las letras ASCII en minúscula
      */
-    int char_to_index(char c);
-    
+    static uint8_t char_to_index(char c);
+
     /**
      * Verifica si un nodo es un nodo terminal
      * @param node: nodo a verificar
      * @return: true si es nodo terminal, false en caso contrario
      */
     bool is_terminal_node(TrieNode* node);
-    
+
     /**
      * Inserta una palabra en el trie
      * @param w: palabra a insertar
      */
     void insert(const string& w);
-    
+
     /**
-     * Desciende por un carácter desde un nodo
-     * @param v: nodo actual
+     * Avanza un carácter desde una posición, dentro de la arista actual o hacia un hijo
+     * @param p: posición actual
      * @param c: carácter por el que descender
-     * @return: puntero al nodo hijo o nullptr si no existe
+     * @return: la nueva posición (con node en nullptr si el prefijo no está en el trie)
      */
-    TrieNode* descend(TrieNode* v, char c);
-    
+    TrieCursor descend(TrieCursor p, char c);
+
     /**
      * Retorna el mejor autocompletado del subárbol
      * @param v: nodo raíz del subárbol
      * @return: puntero al nodo terminal con mejor prioridad o nullptr
      */
     TrieNode* autocomplete(TrieNode* v);
-    
+
+    /**
+     * Retorna los k mejores autocompletados del subárbol, leyendo la lista del nodo (sin recorrer el subárbol)
+     * @param v: nodo raíz del subárbol
+     * @param k: cantidad de sugerencias (se usan a lo más top_k)
+     * @return: nodos terminales de mayor a menor prioridad
+     */
+    vector<TrieNode*> autocomplete_k(TrieNode* v, int k);
+
+    /**
+     * Retorna la palabra de un nodo terminal
+     * @param terminal: nodo terminal
+     * @return: la palabra tal como se insertó
+     */
+    const string& get_word(TrieNode* terminal);
+
     /**
      * Actualiza prioridad según variante de frecuencia
      * @param terminal: nodo terminal a actualizar
      */
     void update_priority_frequency(TrieNode* terminal);
-    
+
     /**
      * Actualiza prioridad según variante de reciente
      * @param terminal: nodo terminal a actualizar
      */
     void update_priority_recent(TrieNode* terminal);
-    
+
     /**
      * Propaga la actualización de best_priority y best_terminal hacia la raíz
+     * Recalcula cada ancestro desde todos sus hijos, así que sirve para cualquier cambio de prioridad.
      * @param v: nodo terminal que fue actualizado
      */
     void propagate_best(TrieNode* v);
-    
+
+    /**
+     * Propaga hacia la raíz un aumento de prioridad, comparando solo contra el mejor de cada ancestro
+     * @param v: nodo terminal cuya prioridad aumentó
+     */
+    void propagate_increase(TrieNode* v);
+
     /**
      * Obtiene el número total de nodos en el trie
      * @return: cantidad de nodos
      */
     long long get_node_count() const;
+
+    /**
+     * Obtiene la memoria reservada por el trie (arenas de nodos y de hijos, y tabla de palabras)
+     * @return: cantidad de bytes
+     */
+    size_t get_memory_bytes() const;
+
+    /**
+     * Convierte el trie en su representación estática (ver frozen_trie.h), con las prioridades actuales
+     * El trie no se modifica, así que puede destruirse después para liberar su memoria.
+     * @return: el trie congelado
+     */
+    FrozenTrie freeze();
+
+private:
+    /**
+     * Busca el hijo de un nodo por una llave
+     * @param v: nodo
+     * @param key: llave del hijo
+     * @return: índice del hijo o NULO si no existe
+     */
+    uint32_t find_child(const TrieNode& v, uint8_t key);
+
+    /**
+     * Busca la posición donde un nodo guarda su hijo por una llave
+     * @param v: nodo
+     * @param key: llave del hijo
+     * @return: puntero a la posición del hijo en su conjunto o nullptr si no existe
+     */
+    uint32_t* find_slot(const TrieNode& v, uint8_t key);
+
+    /**
+     * Agrega un hijo a un nodo, pasando su conjunto de hijos al tipo siguiente si está lleno
+     * @param parent: índice del nodo padre
+     * @param key: llave del hijo
+     * @param child: índice del hijo
+     */
+    void add_child(uint32_t parent, uint8_t key, uint32_t child);
+
+    /**
+     * Recalcula best_priority y best_terminal de un nodo a partir de sus hijos y de su propia palabra
+     * @param v: nodo a recalcular
+     */
+    void recompute_best(TrieNode& v);
+
+    /**
+     * Recalcula la lista de candidatos de un nodo a partir de las de sus hijos y de su propia palabra
+     * @param v: nodo a recalcular
+     * @param updated: nodo terminal cuya prioridad cambió
+     * @return: true si la lista cambió o contiene a updated (y entonces hay que seguir propagando)
+     */
+    bool recompute_top(TrieNode& v, uint32_t updated);
+
+    /**
+     * Reserva un nodo nuevo (y su lista de candidatos)
+     * @return: índice del nodo
+     */
+    uint32_t new_node();
+
+    /**
+     * Orden de dos palabras con la misma prioridad: la que sigue el hijo de menor byte va primero, y una palabra
+     * va después de las que la extienden (igual que en recompute_best)
+     * @param a: nodo terminal
+     * @param b: nodo terminal
+     * @return: true si a va antes que b
+     */
+    bool tie_before(uint32_t a, uint32_t b);
+
+    /**
+     * Sube en la lista de candidatos de un nodo a un nodo terminal cuya prioridad aumentó (o lo agrega si ahora entra)
+     * @param v: índice del nodo
+     * @param updated: nodo terminal
+     * @return: true si la lista cambió o contiene a updated
+     */
+    bool raise_in_top(uint32_t v, uint32_t updated);
+
+    /**
+     * Recorre los hijos de un nodo en orden de byte
+     * @param v: nodo
+     * @param f: función que recibe la llave y el índice de cada hijo
+     */
+    template <class F>
+    void for_each_child(const TrieNode& v, F f) {
+        if (v.children == NULO) return;
+        switch (v.kind) {
+            case NODE4: {
+                const Node4& n = nodes4[v.children];
+                for (int i = 0; i < v.count; i++) f(n.keys[i], n.child[i]);
+                break;
+            }
+            case NODE16: {
+                const Node16& n = nodes16[v.children];
+                for (int i = 0; i < v.count; i++) f(n.keys[i], n.child[i]);
+                break;
+            }
+            case NODE48: {
+                const Node48& n = nodes48[v.children];
+                for (int b = 0; b < ALFABETO; b++) {
+                    if (n.index[b]) f((uint8_t)b, n.child[n.index[b] - 1]);
+                }
+                break;
+            }
+            default: {
+                const Node256& n = nodes256[v.children];
+                for (int b = 0; b < ALFABETO; b++) {
+                    if (n.child[b] != NULO) f((uint8_t)b, n.child[b]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Retorna un carácter de la etiqueta de la arista que llega a un nodo
+     * @param v: nodo
+     * @param i: posición en la etiqueta
+     * @return: el byte del carácter
+     */
+    uint8_t label_at(const TrieNode& v, uint32_t i);
+
+    /**
+     * Crea los nodos para el resto de una palabra bajo un nodo
+     * @param parent: índice del nodo padre
+     * @param word: índice que tendrá la palabra en words
+     * @param w: palabra
+     * @param from: posición del primer carácter que falta
+     * @return: índice del último nodo creado
+     */
+    uint32_t add_tail(uint32_t parent, uint32_t word, const string& w, size_t from);
+
+    /**
+     * Parte la arista que llega a un nodo dejando un nodo intermedio después de sus primeros len caracteres
+     * @param node: índice del nodo
+     * @param len: caracteres de la etiqueta que quedan sobre el nodo intermedio
+     * @return: índice del nodo intermedio
+     */
+    uint32_t split_edge(uint32_t node, uint32_t len);
 };
 
 /**
@@ -124,4 +365,4 @@ struct Trie {
  */
 TrieNode* get_terminal(Trie& trie, const string& word);
 
-#endif // TRIE_H
\ No newline at end of file
+#endif // TRIE_H